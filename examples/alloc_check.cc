@@ -0,0 +1,107 @@
+// 文件: rein_log/examples/alloc_check.cc
+
+// 同步输出路径的零分配检查：替换全局 operator new 统计堆分配次数，
+// 预热（事件池、线程名、时区等一次性初始化）之后，每条日志都不应再有堆分配。
+// 覆盖即时格式化、延迟格式化，以及两个同布局 Appender 共享一次渲染的路径。
+// 任何一项有分配时返回非零，由 ctest 运行。
+#include <log/logging.h>
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+
+namespace {
+
+std::atomic<uint64_t> g_allocations{0};
+
+constexpr int kWarmup = 1000;
+constexpr int kIterations = 10000;
+
+}  // namespace
+
+void* operator new(size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size) { return operator new(size); }
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t& tag) noexcept {
+    return operator new(size, tag);
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t) noexcept { std::free(p); }
+
+namespace {
+
+// 预热后执行 kIterations 次 fn，返回平均每次的分配次数
+template <typename Fn>
+double CountAllocations(Fn&& fn) {
+    for (int i = 0; i < kWarmup; ++i) {
+        fn(i);
+    }
+    const uint64_t before = g_allocations.load(std::memory_order_relaxed);
+    for (int i = 0; i < kIterations; ++i) {
+        fn(i);
+    }
+    return static_cast<double>(g_allocations.load(std::memory_order_relaxed) - before) /
+           kIterations;
+}
+
+bool Check(const char* name, double per_call) {
+    std::printf("  %-36s: %.4f allocations per call\n", name, per_call);
+    return per_call == 0;
+}
+
+}  // namespace
+
+int main() {
+    rein::log::LogManager::instance().AddLogger("alloc");
+    auto logger = REIN_GET_LOGGER("alloc");
+    logger->ClearAppenders();
+    logger->AddAppender(std::make_shared<rein::log::FileAppender>("/dev/null"));
+    logger->SetLevel(rein::log::Level(rein::log::LevelType::kInfo));
+
+    const std::string user = "alice";
+    bool ok = true;
+    std::printf("synchronous path, after %d warm-up calls\n", kWarmup);
+
+    ok &= Check("REIN_LOG_INFO", CountAllocations([&](int i) {
+                    REIN_LOG_INFO(logger, "user {} request {} took {} ms", user, i, 1.5);
+                }));
+
+    logger->SetDeferred(true);
+    ok &= Check("REIN_LOG_INFO (deferred)", CountAllocations([&](int i) {
+                    REIN_LOG_INFO(logger, "user {} request {} took {} ms", user, i, 1.5);
+                }));
+    logger->SetDeferred(false);
+
+    ok &= Check("disabled REIN_LOG_DEBUG", CountAllocations([&](int i) {
+                    REIN_LOG_DEBUG(logger, "user {} request {}", user, i);
+                }));
+
+    // 第二个同布局的 Appender：走 CallAppenders 中共享渲染结果的路径
+    logger->AddAppender(std::make_shared<rein::log::FileAppender>("/dev/null"));
+    ok &= Check("REIN_LOG_INFO (two appenders)", CountAllocations([&](int i) {
+                    REIN_LOG_INFO(logger, "user {} request {} took {} ms", user, i, 1.5);
+                }));
+
+    if (!ok) {
+        std::printf("FAILED: steady-state logging allocated on the heap\n");
+        return 1;
+    }
+    return 0;
+}
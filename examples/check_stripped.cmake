@@ -0,0 +1,25 @@
+# 检查编译期级别裁剪：被裁剪的日志语句不能在目标文件中留下格式串、Logger 调用或参数求值。
+# 用法: cmake -DOBJECT=<strip_check 的目标文件> -P check_stripped.cmake
+if(NOT EXISTS "${OBJECT}")
+    message(FATAL_ERROR "Object file not found: ${OBJECT}")
+endif()
+
+# 目标文件的字符串表里同时有字面量与符号名（Logger::debug 的修饰名含 "5debugI"）
+file(STRINGS "${OBJECT}" contents)
+
+foreach(forbidden rein_stripped_debug_marker rein_stripped_info_marker rein_stripped_site_marker
+                  StrippedArgument 6Logger5debugI 6Logger4infoI)
+    string(FIND "${contents}" "${forbidden}" position)
+    if(NOT position EQUAL -1)
+        message(FATAL_ERROR "'${forbidden}' found in ${OBJECT}: statement was not stripped")
+    endif()
+endforeach()
+
+foreach(required rein_kept_warn_marker rein_kept_site_marker)
+    string(FIND "${contents}" "${required}" position)
+    if(position EQUAL -1)
+        message(FATAL_ERROR "'${required}' missing from ${OBJECT}: check is not effective")
+    endif()
+endforeach()
+
+message(STATUS "No stripped log statement left in ${OBJECT}")
@@ -0,0 +1,149 @@
+// 文件: rein_log/examples/dedup_check.cc
+
+// DedupAppender 的检查：包装一个 FileAppender，核对写进文件的行。
+//   1. 连续的重复折叠成一行汇总，Logger::Flush() 把被包装 Appender 的缓冲写进文件；
+//   2. 记录表满时淘汰最久未出现的消息，它的汇总行出现在挤掉它的新消息之前；
+//   3. 定时汇总只写出汇总行，不刷新被包装 Appender 的缓冲。
+// 任何一项不符合预期时返回非零，由 ctest 运行。
+#include <log/logging.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using rein::log::DedupAppender;
+using rein::log::FileAppender;
+
+bool Check(bool condition, const char* what) {
+    if (!condition) {
+        std::printf("FAILED: %s\n", what);
+    }
+    return condition;
+}
+
+// 所有消息出自同一个调用点，只靠正文区分
+void Emit(const std::shared_ptr<rein::log::Logger>& logger, const char* message) {
+    REIN_LOG_INFO(logger, "{}", message);
+}
+
+std::vector<std::string> ReadLines(const std::string& path) {
+    std::ifstream in(path);
+    std::vector<std::string> lines;
+    for (std::string line; std::getline(in, line);) {
+        lines.push_back(line);
+    }
+    return lines;
+}
+
+// 汇总行带有耗时，只比较之前的部分
+bool Matches(const std::vector<std::string>& lines, const std::vector<std::string>& expected) {
+    if (lines.size() != expected.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < lines.size(); ++i) {
+        if (lines[i].compare(0, expected[i].size(), expected[i]) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void Print(const char* name, const std::vector<std::string>& lines) {
+    std::printf("%s:\n", name);
+    for (const auto& line : lines) {
+        std::printf("  %s\n", line.c_str());
+    }
+}
+
+// 文件 Appender 使用默认的 64KB 缓冲，INFO 日志只有显式刷新时才写进文件
+struct Fixture {
+    Fixture(const char* name, size_t window, std::chrono::milliseconds interval)
+        : path(std::string("dedup_check_") + name + ".log") {
+        ::unlink(path.c_str());
+        rein::log::LogManager::instance().AddLogger(name);
+        logger = REIN_GET_LOGGER(name);
+        logger->ClearAppenders();
+        file = std::make_shared<FileAppender>(path);
+        file->SetLayout("%m%n");
+        dedup = std::make_shared<DedupAppender>(file, window, interval);
+        logger->AddAppender(dedup);
+    }
+
+    ~Fixture() {
+        logger->ClearAppenders();
+        dedup.reset();
+        file.reset();
+        ::unlink(path.c_str());
+    }
+
+    std::string path;
+    std::shared_ptr<rein::log::Logger> logger;
+    std::shared_ptr<FileAppender> file;
+    std::shared_ptr<DedupAppender> dedup;
+};
+
+bool CheckCollapse() {
+    Fixture fixture("collapse", 1, std::chrono::milliseconds(0));
+    for (int i = 0; i < 100; ++i) {
+        Emit(fixture.logger, "A");
+    }
+    Emit(fixture.logger, "B");
+    bool ok = Check(ReadLines(fixture.path).empty(), "file written before any flush");
+
+    fixture.logger->Flush();
+    std::vector<std::string> lines = ReadLines(fixture.path);
+    Print("collapse", lines);
+    ok &= Check(Matches(lines, {"A", "last message repeated 99 times in ", "B"}),
+                "repeats not collapsed into one summary, or Logger::Flush() missed the file");
+    ok &= Check(fixture.dedup->suppressed() == 99, "suppressed count");
+    return ok;
+}
+
+bool CheckEviction() {
+    Fixture fixture("eviction", 2, std::chrono::milliseconds(0));
+    for (const char* message : {"A", "B", "A", "A", "B", "C", "D"}) {
+        Emit(fixture.logger, message);
+    }
+    fixture.logger->Flush();
+    std::vector<std::string> lines = ReadLines(fixture.path);
+    Print("eviction", lines);
+    // C 挤掉最久未出现的 A，D 挤掉 B；汇总行在新消息之前
+    bool ok = Check(Matches(lines, {"A", "B", "message repeated 2 times in ", "C",
+                                    "message repeated 1 times in ", "D"}),
+                    "wrong eviction order");
+    ok &= Check(lines.size() == 6 && lines[2].substr(lines[2].size() - 3) == ": A" &&
+                    lines[4].substr(lines[4].size() - 3) == ": B",
+                "summary names the wrong message");
+    return ok;
+}
+
+bool CheckTimer() {
+    Fixture fixture("timer", 1, std::chrono::milliseconds(50));
+    for (int i = 0; i < 10; ++i) {
+        Emit(fixture.logger, "A");
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    bool ok = Check(ReadLines(fixture.path).empty(), "summary timer flushed the target");
+
+    fixture.file->Flush();
+    std::vector<std::string> lines = ReadLines(fixture.path);
+    Print("timer", lines);
+    ok &= Check(Matches(lines, {"A", "last message repeated 9 times in "}),
+                "summary timer did not write the summary");
+    return ok;
+}
+
+}  // namespace
+
+int main() {
+    bool ok = CheckCollapse();
+    ok &= CheckEviction();
+    ok &= CheckTimer();
+    return ok ? 0 : 1;
+}
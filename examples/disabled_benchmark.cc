@@ -0,0 +1,56 @@
+// 文件: rein_log/examples/disabled_benchmark.cc
+
+// 未开启级别的日志语句的开销：
+//   REIN_LOG_DEBUG        宏内先做一次 relaxed 读取判断级别，参数不求值
+//   logger->debug(...)    直接调用成员函数，参数先求值、再在函数里判断级别（原来宏的行为）
+//   REIN_LOG_DEBUG_LAZY   惰性版本，级别关闭时 callable 不会被调用
+// 作为参照同时给出空循环的耗时。
+#include <log/logging.h>
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+namespace {
+
+constexpr int kIterations = 20000000;
+
+// 代表代价较高的参数表达式
+__attribute__((noinline)) std::string Describe(int i) { return "request #" + std::to_string(i); }
+
+template <typename Fn>
+double Measure(Fn&& fn, int iterations = kIterations) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        fn(i);
+        asm volatile("" ::: "memory");  // 防止整个循环被优化掉
+    }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() /
+           iterations * 1e9;
+}
+
+}  // namespace
+
+int main() {
+    rein::log::LogManager::instance().AddLogger("disabled");
+    auto logger = REIN_GET_LOGGER("disabled");
+    logger->ClearAppenders();
+    logger->SetLevel(rein::log::Level(rein::log::LevelType::kWarn));
+
+    double empty = Measure([](int) {});
+    double macro = Measure([&](int i) { REIN_LOG_DEBUG(logger, "state {}", Describe(i)); });
+    double lazy = Measure([&](int i) { REIN_LOG_DEBUG_LAZY(logger, [&] { return Describe(i); }); });
+    // 参数先求值，构造字符串的代价无法避免，循环次数少一些
+    double eager = Measure(
+        [&](int i) {
+            logger->debug(__FILE__, __LINE__, __func__, REIN_FMT("state {}"), Describe(i));
+        },
+        kIterations / 10);
+
+    std::printf("disabled DEBUG statement (logger at WARN)\n");
+    std::printf("  empty loop            : %6.2f ns\n", empty);
+    std::printf("  REIN_LOG_DEBUG        : %6.2f ns\n", macro);
+    std::printf("  REIN_LOG_DEBUG_LAZY   : %6.2f ns\n", lazy);
+    std::printf("  arguments evaluated   : %6.2f ns  (logger->debug called directly)\n", eager);
+    return 0;
+}
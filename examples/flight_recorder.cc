@@ -0,0 +1,79 @@
+// 文件: rein_log/examples/flight_recorder.cc
+
+// 飞行记录器的两种写出时机：
+//   flight_recorder          记录大量 DEBUG 日志（控制台只显示 WARN 以上），遇到 FATAL 时写出最近的事件
+//   flight_recorder crash    安装信号处理函数后解引用空指针，进程被 SIGSEGV 杀死前写出最近的事件
+#include <log/logging.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr int kWorkerThreads = 4;
+constexpr int kEventsPerThread = 100000;
+
+std::shared_ptr<rein::log::Logger> MakeLogger(
+    const std::shared_ptr<rein::log::FlightRecorderAppender>& recorder) {
+    rein::log::LogManager::instance().AddLogger("flight");
+    auto logger = REIN_GET_LOGGER("flight");
+    logger->SetLevel(rein::log::Level(rein::log::LevelType::kDebug));
+    logger->ClearAppenders();
+    logger->AddAppender(recorder);
+
+    // 控制台只输出 WARN 以上，DEBUG/INFO 只进入飞行记录器
+    auto console = std::make_shared<rein::log::ConsoleAppender>(kConsole);
+    console->SetLevel(rein::log::LevelType::kWarn);
+    logger->AddAppender(console);
+    return logger;
+}
+
+int Crash() {
+    rein::log::FlightRecorderAppender::InstallSignalHandlers();
+    auto logger = MakeLogger(std::make_shared<rein::log::FlightRecorderAppender>("", 16));
+    for (int i = 0; i < 100; ++i) {
+        REIN_LOG_DEBUG(logger, "step {} before the crash", i);
+    }
+    REIN_LOG_WARN(logger, "dereferencing a null pointer");
+    volatile int* pointer = nullptr;
+    *pointer = 1;
+    return 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    if (argc > 1 && std::strcmp(argv[1], "crash") == 0) {
+        return Crash();
+    }
+
+    auto recorder = std::make_shared<rein::log::FlightRecorderAppender>("flight_recorder.log");
+    auto logger = MakeLogger(recorder);
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (int t = 0; t < kWorkerThreads; ++t) {
+        workers.emplace_back([&, t]() {
+            for (int i = 0; i < kEventsPerThread; ++i) {
+                REIN_LOG_DEBUG(logger, "thread {} iteration {} value {}", t, i, 3.14);
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    double seconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::printf("recorded %llu events, %.0f ns per call, %llu dropped\n",
+                static_cast<unsigned long long>(recorder->recorded()),
+                seconds / (kWorkerThreads * kEventsPerThread) * 1e9,
+                static_cast<unsigned long long>(recorder->dropped()));
+
+    REIN_LOG_WARN(logger, "something looks wrong");
+    REIN_LOG_FATAL(logger, "giving up, the last {} events are in flight_recorder.log",
+                   recorder->capacity());
+    return 0;
+}
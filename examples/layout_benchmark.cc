@@ -0,0 +1,146 @@
+// 文件: rein_log/examples/layout_benchmark.cc
+
+// 编译后的 Layout 指令序列与原来逐个 FormatterItem 格式化的对比，布局为 kDefaultLayout。
+// 原来的实现已被替换，这里按原样重建了一份：每个占位符一个 shared_ptr<FormatterItem>，
+// 逐个虚函数调用，字面量之外都经过 fmt::format_to(..., "{}", ...)，级别名查表并拷贝成 std::string。
+// 两者使用同一个 DateTimeFormatter，差别只在其余占位符的解释方式。
+#include <log/logging.h>
+#include <log/formatter.h>
+
+#include <chrono>
+#include <cstdio>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+using rein::log::Layout;
+using rein::log::LogEvent;
+
+constexpr int kIterations = 2000000;
+
+// ---- 原来的逐项格式化 ----
+
+class LiteralItem final : public Layout::FormatterItem {
+public:
+    explicit LiteralItem(std::string text) : text_(std::move(text)) {}
+    void format(fmt::memory_buffer& buffer, const std::shared_ptr<LogEvent>&) override {
+        buffer.append(text_.data(), text_.data() + text_.size());
+    }
+
+private:
+    std::string text_;
+};
+
+class LevelItem final : public Layout::FormatterItem {
+public:
+    void format(fmt::memory_buffer& buffer, const std::shared_ptr<LogEvent>& event) override {
+        fmt::format_to(std::back_inserter(buffer), "{}",
+                       rein::log::Level::ToString(event->level().level()));
+    }
+};
+
+class NameItem final : public Layout::FormatterItem {
+public:
+    void format(fmt::memory_buffer& buffer, const std::shared_ptr<LogEvent>& event) override {
+        fmt::format_to(std::back_inserter(buffer), "{}", event->logger()->name());
+    }
+};
+
+class FileItem final : public Layout::FormatterItem {
+public:
+    void format(fmt::memory_buffer& buffer, const std::shared_ptr<LogEvent>& event) override {
+        fmt::format_to(std::back_inserter(buffer), "{}", event->file());
+    }
+};
+
+class LineItem final : public Layout::FormatterItem {
+public:
+    void format(fmt::memory_buffer& buffer, const std::shared_ptr<LogEvent>& event) override {
+        fmt::format_to(std::back_inserter(buffer), "{}", event->line());
+    }
+};
+
+class MessageItem final : public Layout::FormatterItem {
+public:
+    void format(fmt::memory_buffer& buffer, const std::shared_ptr<LogEvent>& event) override {
+        auto message = event->message();
+        buffer.append(message.data(), message.data() + message.size());
+    }
+};
+
+class NewLineItem final : public Layout::FormatterItem {
+public:
+    void format(fmt::memory_buffer& buffer, const std::shared_ptr<LogEvent>&) override {
+        fmt::format_to(std::back_inserter(buffer), "\n");
+    }
+};
+
+// kDefaultLayout: "%d{:%Y-%m-%d %H:%M:%S.%f} [%p] [%c] %f:%l %m%n"
+std::vector<std::shared_ptr<Layout::FormatterItem>> DefaultItems() {
+    return {std::make_shared<rein::log::DateTimeFormatter>(":%Y-%m-%d %H:%M:%S.%f"),
+            std::make_shared<LiteralItem>(" ["),
+            std::make_shared<LevelItem>(),
+            std::make_shared<LiteralItem>("] ["),
+            std::make_shared<NameItem>(),
+            std::make_shared<LiteralItem>("] "),
+            std::make_shared<FileItem>(),
+            std::make_shared<LiteralItem>(":"),
+            std::make_shared<LineItem>(),
+            std::make_shared<LiteralItem>(" "),
+            std::make_shared<MessageItem>(),
+            std::make_shared<NewLineItem>()};
+}
+
+template <typename Fn>
+double Measure(Fn&& fn) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < kIterations; ++i) {
+        fn();
+    }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() /
+           kIterations * 1e9;
+}
+
+}  // namespace
+
+int main() {
+    rein::log::LogManager::instance().AddLogger("layout");
+    auto logger = REIN_GET_LOGGER("layout");
+    auto event = std::make_shared<LogEvent>(rein::log::Level(rein::log::LevelType::kInfo),
+                                            __FILE__, __LINE__, __func__,
+                                            fmt::string_view("user 42 logged in"), logger);
+
+    auto items = DefaultItems();
+    Layout layout(kDefaultLayout);
+    fmt::memory_buffer expected;
+    fmt::memory_buffer actual;
+    for (auto& item : items) {
+        item->format(expected, event);
+    }
+    layout.format(actual, event);
+    if (fmt::to_string(expected) != fmt::to_string(actual)) {
+        std::printf("outputs differ:\n  %s  %s", fmt::to_string(expected).c_str(),
+                    fmt::to_string(actual).c_str());
+        return 1;
+    }
+
+    fmt::memory_buffer buffer;
+    double per_item = Measure([&] {
+        buffer.clear();
+        for (auto& item : items) {
+            item->format(buffer, event);
+        }
+    });
+    double compiled = Measure([&] {
+        buffer.clear();
+        layout.format(buffer, event);
+    });
+
+    std::printf("kDefaultLayout, %zu bytes per event\n", buffer.size());
+    std::printf("  FormatterItem per token : %6.1f ns\n", per_item);
+    std::printf("  compiled program        : %6.1f ns\n", compiled);
+    return 0;
+}
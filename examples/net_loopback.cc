@@ -0,0 +1,235 @@
+// 文件: rein_log/examples/net_loopback.cc
+
+// NetAppender 的回环检查：在本机回环地址上起一个 TCP 监听者，
+// 用 NetAppender 发送日志并核对收到的内容；
+// 中途关闭监听者再在同一端口重新打开，检查断开期间写日志不阻塞、缓冲的记录在重连后补发；
+// 最后对一个无人监听的端口写入，检查缓冲的数据不超过 buffer_limit。
+// 任何一项不符合预期时返回非零，由 ctest 运行。
+// 用法: net_loopback [在线阶段的条数]
+#include <log/logging.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// 断开期间写入的条数，远小于 kDefaultNetBufferLimit，不应有丢弃
+constexpr int kOfflineEvents = 1000;
+constexpr auto kTimeout = std::chrono::seconds(10);
+// 缓冲上限检查：对端始终不可用，写入的记录总量是上限的数倍
+constexpr size_t kSmallBufferLimit = 4096;
+constexpr int kOverflowEvents = 1000;
+
+// 接受一个连接，按行收集收到的内容，直到对端关闭或 Close()
+class Listener {
+public:
+    explicit Listener(int port = 0) {
+        fd_ = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        int on = 1;
+        ::setsockopt(fd_, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+        sockaddr_in addr = {};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = htons(static_cast<uint16_t>(port));
+        socklen_t length = sizeof(addr);
+        if (::bind(fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 ||
+            ::listen(fd_, 1) < 0 ||
+            ::getsockname(fd_, reinterpret_cast<sockaddr*>(&addr), &length) < 0) {
+            std::perror("listener");
+            std::exit(1);
+        }
+        port_ = ntohs(addr.sin_port);
+        thread_ = std::thread([this]() {
+            int conn = ::accept(fd_, nullptr, nullptr);
+            if (conn < 0) {
+                return;
+            }
+            conn_ = conn;
+            char buffer[64 * 1024];
+            std::string partial;
+            ssize_t n;
+            while ((n = ::read(conn, buffer, sizeof(buffer))) > 0) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                for (ssize_t i = 0; i < n; ++i) {
+                    if (buffer[i] == '\n') {
+                        lines_.push_back(std::move(partial));
+                        partial.clear();
+                    } else {
+                        partial.push_back(buffer[i]);
+                    }
+                }
+            }
+            ::close(conn);
+        });
+    }
+
+    ~Listener() { Close(); }
+
+    void Close() {
+        if (fd_ >= 0) {
+            ::shutdown(conn_.load(), SHUT_RDWR);  // 结束读取，对端看到连接关闭
+            ::shutdown(fd_, SHUT_RDWR);
+            ::close(fd_);
+            fd_ = -1;
+        }
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+    }
+
+    int port() const { return port_; }
+
+    std::vector<std::string> lines() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return lines_;
+    }
+
+    // 等到至少收到 count 行，超时返回 false
+    bool WaitFor(size_t count) const {
+        auto deadline = std::chrono::steady_clock::now() + kTimeout;
+        while (lines().size() < count) {
+            if (std::chrono::steady_clock::now() > deadline) {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        return true;
+    }
+
+private:
+    int fd_ = -1;
+    int port_ = 0;
+    std::atomic<int> conn_{-1};
+    mutable std::mutex mutex_;
+    std::vector<std::string> lines_;
+    std::thread thread_;
+};
+
+bool WaitUntil(const std::function<bool()>& done) {
+    auto deadline = std::chrono::steady_clock::now() + kTimeout;
+    while (!done()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return true;
+}
+
+bool Check(bool condition, const char* what) {
+    if (!condition) {
+        std::printf("FAILED: %s\n", what);
+    }
+    return condition;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    int events = argc > 1 ? std::atoi(argv[1]) : 100000;
+
+    auto listener = std::make_shared<Listener>();
+    int port = listener->port();
+    auto appender =
+        std::make_shared<rein::log::NetAppender>("tcp://127.0.0.1:" + std::to_string(port));
+    appender->SetLayout("%m%n");
+    rein::log::LogManager::instance().AddLogger("net");
+    auto logger = REIN_GET_LOGGER("net");
+    logger->ClearAppenders();
+    logger->AddAppender(appender);
+    bool ok = true;
+
+    // 1. 对端在线：全部按顺序送达
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < events; ++i) {
+        REIN_LOG_INFO(logger, "online {}", i);
+    }
+    double seconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    logger->Flush();
+    ok &= Check(listener->WaitFor(static_cast<size_t>(events)), "online records not delivered");
+    std::vector<std::string> received = listener->lines();
+    std::printf("online : sent %d, received %zu, %.0f ns per call\n", events, received.size(),
+                seconds / events * 1e9);
+    bool in_order = received.size() == static_cast<size_t>(events);
+    for (size_t i = 0; in_order && i < received.size(); ++i) {
+        in_order = received[i] == "online " + std::to_string(i);
+    }
+    ok &= Check(in_order, "online records missing, duplicated or out of order");
+
+    // 2. 对端下线：后台线程发现断开，写日志不阻塞，记录留在缓冲区中
+    listener->Close();
+    ok &= Check(WaitUntil([&] {
+                    REIN_LOG_INFO(logger, "probe");  // 有数据要发时才会发现连接已断开
+                    return !appender->connected();
+                }),
+                "disconnect not detected");
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < kOfflineEvents; ++i) {
+        REIN_LOG_INFO(logger, "offline {}", i);
+    }
+    seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::printf("offline: connected %d, dropped %llu, %.0f ns per call\n", appender->connected(),
+                static_cast<unsigned long long>(appender->dropped()),
+                seconds / kOfflineEvents * 1e9);
+    ok &= Check(appender->dropped() == 0, "records dropped below the buffer limit");
+    ok &= Check(seconds < 1.0, "logging blocked while the peer was down");
+
+    // 3. 对端恢复：退避重连后补发缓冲的全部记录
+    listener = std::make_shared<Listener>(port);
+    ok &= Check(WaitUntil([&] { return appender->connected(); }), "did not reconnect");
+    logger->Flush();
+    const std::string last = "offline " + std::to_string(kOfflineEvents - 1);
+    std::vector<std::string> resumed;
+    WaitUntil([&] {
+        resumed = listener->lines();
+        return !resumed.empty() && resumed.back() == last;
+    });
+    size_t offline = 0;
+    for (const auto& line : resumed) {
+        if (line == "offline " + std::to_string(offline)) {
+            ++offline;
+        }
+    }
+    std::printf("resumed: received %zu lines, %zu of %d offline records in order\n",
+                resumed.size(), offline, kOfflineEvents);
+    ok &= Check(offline == static_cast<size_t>(kOfflineEvents),
+                "buffered records not resent after reconnect");
+
+    // 4. 缓冲上限：发送线程换走的一批与待发送缓冲区合计不超过 buffer_limit
+    int closed_port = std::make_shared<Listener>()->port();  // 监听者随即关闭，端口上无人接受连接
+    auto limited = std::make_shared<rein::log::NetAppender>(
+        "tcp://127.0.0.1:" + std::to_string(closed_port), rein::log::NetFraming::kNewline,
+        kSmallBufferLimit);
+    limited->SetLayout("%m%n");
+    logger->ClearAppenders();
+    logger->AddAppender(limited);
+    for (int i = 0; i < kOverflowEvents; ++i) {
+        if (i == kOverflowEvents / 5) {
+            // 让发送线程先换走前一部分，之后的记录重新填满待发送缓冲区
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+        REIN_LOG_INFO(logger, "overflow {:04}", i);
+    }
+    const size_t record_size = std::string("overflow 0000\n").size();
+    const size_t held = (kOverflowEvents - static_cast<size_t>(limited->dropped())) * record_size;
+    std::printf("limit  : %zu bytes held of %zu written, buffer limit %zu\n", held,
+                kOverflowEvents * record_size, kSmallBufferLimit);
+    ok &= Check(limited->dropped() > 0, "nothing dropped above the buffer limit");
+    ok &= Check(held <= kSmallBufferLimit,
+                "more than buffer_limit bytes held while the peer was down");
+
+    REIN_REMOVE_LOGGER("net");
+    return ok ? 0 : 1;
+}
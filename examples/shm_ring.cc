@@ -0,0 +1,327 @@
+// 文件: rein_log/examples/shm_ring.cc
+
+// 共享内存环的检查与查看工具：
+//   shm_ring [条数]         依次检查绕回、套圈、记录被写坏时的校验，再 fork 出写日志的子进程，
+//                           父进程读取并核对内容、顺序与丢失计数；
+//                           任何一项不符合预期时返回非零，由 ctest 运行
+//   shm_ring tail <名字>    作为采集端持续读取已有的环，把记录打印到标准输出
+#include <log/logging.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using rein::log::ShmRecord;
+using rein::log::ShmRingAppender;
+using rein::log::ShmRingReader;
+
+constexpr int kProducerThreads = 4;
+constexpr size_t kSmallRing = 4096;  // 最小容量，几百条记录就绕回多圈
+constexpr int kWrapRecords = 2000;
+
+bool Check(bool condition, const char* what) {
+    if (!condition) {
+        std::printf("FAILED: %s\n", what);
+    }
+    return condition;
+}
+
+// 每个进程用自己的对象名，并行运行的检查互不干扰
+std::string RingName(const char* suffix) {
+    return "/rein_log_check_" + std::to_string(::getpid()) + "_" + suffix;
+}
+
+// 第 seq 条记录的内容：长度在 1~300 字节之间变化，使记录头与内容都会落在数据区末尾两侧
+std::string Payload(int seq) {
+    std::string data(static_cast<size_t>(1 + seq * 37 % 300), '\0');
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<char>('a' + (seq + i) % 26);
+    }
+    return data;
+}
+
+// 没有新记录时先自旋，再逐步让出 CPU；读到记录之后没有任何系统调用
+void Idle(int& idle) {
+    if (++idle < 64) {
+        return;
+    }
+    std::this_thread::sleep_for(std::chrono::microseconds(idle < 1024 ? 10 : 1000));
+}
+
+// 1. 绕回：小容量的环写过多圈，读者每次落后不到一圈，应按顺序读到全部记录且内容不变
+bool CheckWraparound() {
+    const std::string name = RingName("wrap");
+    ShmRingAppender::Remove(name);
+    bool ok = true;
+    {
+        ShmRingAppender ring(name, kSmallRing);
+        ShmRingReader reader(name);
+        ShmRecord record;
+        const uint64_t mask = ring.capacity() - 1;
+        int read = 0;
+        int straddled = 0;
+        uint64_t expected_position = 0;
+        for (int seq = 0; seq < kWrapRecords;) {
+            // 每批 1~8 条，最多 8 * 328 字节，不超过一圈
+            for (int batch = seq % 8 + 1; batch > 0 && seq < kWrapRecords; --batch, ++seq) {
+                std::string data = Payload(seq);
+                ok &= Check(ring.Publish(data.data(), data.size()), "publish failed");
+            }
+            while (reader.Next(record)) {
+                std::string data = Payload(read);
+                ok &= Check(record.position == expected_position, "record position skipped");
+                ok &= Check(record.type == rein::log::kShmRecordBinary, "record type changed");
+                ok &= Check(record.data.size() == data.size() &&
+                                std::memcmp(record.data.data(), data.data(), data.size()) == 0,
+                            "record content changed across the ring end");
+                if ((record.position & mask) + rein::log::kShmRecordHeaderSize + data.size() >
+                    ring.capacity()) {
+                    ++straddled;
+                }
+                expected_position += rein::log::kShmRecordHeaderSize + (data.size() + 7) / 8 * 8;
+                ++read;
+            }
+        }
+        std::printf("wrap   : %d of %d records, %llu laps, %d across the ring end, %llu overruns\n",
+                    read, kWrapRecords,
+                    static_cast<unsigned long long>(expected_position / ring.capacity()),
+                    straddled, static_cast<unsigned long long>(reader.overruns()));
+        ok &= Check(read == kWrapRecords, "records lost while the reader kept up");
+        ok &= Check(reader.overruns() == 0 && reader.lost_bytes() == 0,
+                    "overrun reported while the reader kept up");
+        ok &= Check(expected_position > 10 * ring.capacity(), "ring did not wrap");
+        ok &= Check(straddled > 0, "no record crossed the ring end");
+    }
+    ShmRingAppender::Remove(name);
+    return ok;
+}
+
+// 2. 套圈：读者落后超过一圈时计一次 overrun，跳到写位置，之后的记录照常读出
+bool CheckLapped() {
+    const std::string name = RingName("lap");
+    ShmRingAppender::Remove(name);
+    bool ok = true;
+    {
+        ShmRingAppender ring(name, kSmallRing);
+        ShmRingReader reader(name);
+        ShmRecord record;
+        uint64_t written = 0;
+        int seq = 0;
+        while (written <= 3 * ring.capacity()) {
+            std::string data = Payload(seq++);
+            ring.Publish(data.data(), data.size());
+            written += rein::log::kShmRecordHeaderSize + (data.size() + 7) / 8 * 8;
+        }
+        ok &= Check(!reader.Next(record), "read a record that had been overwritten");
+        ok &= Check(reader.overruns() == 1, "lapped reader not detected");
+        ok &= Check(reader.lost_bytes() == written, "lost bytes do not match the skipped range");
+        ok &= Check(reader.position() == written, "reader did not resync to the head");
+
+        std::string data = Payload(seq);
+        ring.Publish(data.data(), data.size());
+        ok &= Check(reader.Next(record) && record.position == written &&
+                        fmt::to_string(record.data) == data,
+                    "no record after resync");
+        std::printf("lapped : %llu overruns, %llu bytes lost, resumed at %llu\n",
+                    static_cast<unsigned long long>(reader.overruns()),
+                    static_cast<unsigned long long>(reader.lost_bytes()),
+                    static_cast<unsigned long long>(record.position));
+    }
+    ShmRingAppender::Remove(name);
+    return ok;
+}
+
+// 3. 记录被写坏：模拟被套圈的生产者迟到的写入，改动一条已提交记录的内容（提交字不变），
+//    读者应由校验字发现，不交出这条记录，计一次 overrun 后从写位置继续
+bool CheckTornRecord() {
+    const std::string name = RingName("torn");
+    ShmRingAppender::Remove(name);
+    bool ok = true;
+    {
+        ShmRingAppender ring(name, kSmallRing);
+        ShmRingReader reader(name);
+        ShmRecord record;
+        const std::string first = Payload(1);
+        const std::string second = Payload(2);
+        ring.Publish(first.data(), first.size());
+        ring.Publish(second.data(), second.size());
+
+        // 另开一个可写映射，直接改第一条记录（位置 0）的内容
+        int fd = ::shm_open(ring.shm_name().c_str(), O_RDWR, 0);
+        struct stat st = {};
+        const bool sized = fd >= 0 && ::fstat(fd, &st) == 0;
+        const size_t size = static_cast<size_t>(st.st_size);
+        void* addr = sized ? ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)
+                           : MAP_FAILED;
+        if (fd >= 0) {
+            ::close(fd);
+        }
+        if (!Check(addr != MAP_FAILED, "could not map the ring for writing")) {
+            ShmRingAppender::Remove(name);
+            return false;
+        }
+        auto* header = static_cast<rein::log::ShmRingHeader*>(addr);
+        char* data = static_cast<char*>(addr) + header->data_offset;
+        data[rein::log::kShmRecordHeaderSize] ^= 0x20;
+        const uint64_t head = header->head.load();
+        ::munmap(addr, size);
+
+        ok &= Check(!reader.Next(record), "corrupted record was delivered");
+        ok &= Check(reader.overruns() == 1, "checksum mismatch not counted as an overrun");
+        ok &= Check(reader.position() == head, "reader did not resync past the corrupted record");
+
+        const std::string third = Payload(3);
+        ring.Publish(third.data(), third.size());
+        ok &= Check(reader.Next(record) && fmt::to_string(record.data) == third,
+                    "no record after the corrupted one was skipped");
+        std::printf("torn   : %llu overruns, %llu bytes skipped\n",
+                    static_cast<unsigned long long>(reader.overruns()),
+                    static_cast<unsigned long long>(reader.lost_bytes()));
+    }
+    ShmRingAppender::Remove(name);
+    return ok;
+}
+
+int Produce(const std::string& name, int events) {
+    auto appender = std::make_shared<ShmRingAppender>(name);
+    appender->SetLayout("%m%n");
+    rein::log::LogManager::instance().AddLogger("shm");
+    auto logger = REIN_GET_LOGGER("shm");
+    logger->ClearAppenders();
+    logger->AddAppender(appender);
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (int t = 0; t < kProducerThreads; ++t) {
+        workers.emplace_back([&, t]() {
+            for (int i = 0; i < events / kProducerThreads; ++i) {
+                REIN_LOG_INFO(logger, "thread {} iteration {} value {}", t, i, 3.14);
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    double seconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::printf("producer: %d records, %.0f ns per call\n",
+                events / kProducerThreads * kProducerThreads, seconds / events * 1e9);
+    return appender->dropped() == 0 ? 0 : 1;
+}
+
+// 4. 跨进程：子进程的多个线程写日志，父进程读取；每个线程的记录按顺序出现，
+//    没有 overrun 时一条不少，有 overrun 时丢失的字节数必须非零
+bool CheckProcesses(int events) {
+    const std::string name = RingName("proc");
+    ShmRingAppender::Remove(name);
+    // 先由父进程创建环，读者从第一条记录开始读
+    { ShmRingAppender ring(name); }
+    ShmRingReader reader(name);
+
+    std::fflush(stdout);
+    pid_t child = ::fork();
+    if (child == 0) {
+        std::exit(Produce(name, events));
+    }
+
+    const int expected = events / kProducerThreads * kProducerThreads;
+    std::vector<int> next(kProducerThreads, 0);
+    size_t records = 0;
+    size_t bytes = 0;
+    bool well_formed = true;
+    bool in_order = true;
+    ShmRecord record;
+    int status = 0;
+    int idle = 0;
+    bool exited = false;
+    for (;;) {
+        if (reader.Next(record)) {
+            ++records;
+            bytes += record.data.size();
+            idle = 0;
+            int t = -1;
+            int i = -1;
+            std::string line = fmt::to_string(record.data);
+            if (std::sscanf(line.c_str(), "thread %d iteration %d value 3.14", &t, &i) != 2 ||
+                t < 0 || t >= kProducerThreads || line.back() != '\n') {
+                well_formed = false;
+                continue;
+            }
+            // 有 overrun 时允许跳过，但不能倒退或重复
+            in_order &= reader.overruns() == 0 ? i == next[t] : i >= next[t];
+            next[t] = i + 1;
+            continue;
+        }
+        // 子进程退出之后再读空一次，确保不漏掉最后的记录
+        if (exited) {
+            break;
+        }
+        exited = ::waitpid(child, &status, WNOHANG) == child;
+        if (!exited) {
+            Idle(idle);
+        }
+    }
+    ShmRingAppender::Remove(name);
+
+    std::printf("reader  : %zu records, %zu bytes, %llu overruns, %llu bytes lost\n", records,
+                bytes, static_cast<unsigned long long>(reader.overruns()),
+                static_cast<unsigned long long>(reader.lost_bytes()));
+    bool ok = Check(WIFEXITED(status) && WEXITSTATUS(status) == 0, "producer failed");
+    ok &= Check(well_formed, "malformed record");
+    ok &= Check(in_order, "records of one thread out of order or duplicated");
+    if (reader.overruns() == 0) {
+        ok &= Check(records == static_cast<size_t>(expected), "records lost without an overrun");
+    } else {
+        ok &= Check(reader.lost_bytes() > 0 && records < static_cast<size_t>(expected),
+                    "overrun reported without lost records");
+    }
+    return ok;
+}
+
+int Tail(const std::string& name) {
+    ShmRingReader reader(name);
+    ShmRecord record;
+    uint64_t overruns = 0;
+    int idle = 0;
+    for (;;) {
+        if (!reader.Next(record)) {
+            Idle(idle);
+            continue;
+        }
+        idle = 0;
+        if (reader.overruns() != overruns) {
+            overruns = reader.overruns();
+            std::fprintf(stderr, "shm_ring: reader fell behind, %llu bytes lost so far\n",
+                         static_cast<unsigned long long>(reader.lost_bytes()));
+        }
+        if (record.type == rein::log::kShmRecordText) {
+            std::fwrite(record.data.data(), 1, record.data.size(), stdout);
+        }
+    }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    if (argc > 2 && std::strcmp(argv[1], "tail") == 0) {
+        return Tail(argv[2]);
+    }
+    int events = argc > 1 ? std::atoi(argv[1]) : 1000000;
+
+    bool ok = CheckWraparound();
+    ok &= CheckLapped();
+    ok &= CheckTornRecord();
+    ok &= CheckProcesses(events);
+    return ok ? 0 : 1;
+}
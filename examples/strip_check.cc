@@ -0,0 +1,22 @@
+// 文件: rein_log/examples/strip_check.cc
+
+// 编译期级别裁剪的检查对象：以 WARN 为阈值编译，只生成目标文件，不链接。
+// check_stripped.cmake 在目标文件中查找下面的标记：被裁剪语句的格式串、调用的 Logger 方法
+// 以及参数中的函数都不应出现，WARN 语句的内容必须出现（证明检查本身有效）。
+#undef REIN_ACTIVE_LEVEL
+#define REIN_ACTIVE_LEVEL REIN_LEVEL_WARN
+#include <log/logging.h>
+
+// 只声明不定义：被裁剪的语句如果求值了参数，目标文件里会留下对它的引用
+int StrippedArgument();
+
+void EmitAll(const std::shared_ptr<rein::log::Logger>& logger) {
+    REIN_LOG_DEBUG(logger, "rein_stripped_debug_marker {}", StrippedArgument());
+    REIN_LOG_INFO(logger, "rein_stripped_info_marker {}", StrippedArgument());
+    REIN_LOG_DEBUG_LAZY(logger, [] { return StrippedArgument(); });
+    REIN_LOG_INFO_LAZY(logger, [] { return StrippedArgument(); });
+    REIN_LOG_EVERY_N(logger, DEBUG, 100, "rein_stripped_site_marker {}", StrippedArgument());
+    REIN_LOG_RATE_LIMITED(logger, INFO, 10, "rein_stripped_site_marker {}", StrippedArgument());
+    REIN_LOG_WARN(logger, "{}", "rein_kept_warn_marker");
+    REIN_LOG_FIRST_N(logger, WARN, 10, "{}", "rein_kept_site_marker");
+}
@@ -0,0 +1,71 @@
+// 文件: rein_log/examples/write_path_benchmark.cc
+
+// 一条日志从布局到交给内核之间的拷贝次数与耗时，输出到 /dev/null：
+//   原来的路径：Layout 渲染进临时缓冲区 -> fmt::to_string 得到 std::string -> fmt::print 拷进 stdio 缓冲区；
+//   现在的路径：FileAppender 让 Layout 直接追加到自己的写缓冲区，攒满后一次 write(2)。
+// 拷贝字节数按每个阶段实际经手的字节累计（不含内核侧的拷贝，两条路径相同）。
+#include <log/logging.h>
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <string>
+
+namespace {
+
+using rein::log::LogEvent;
+
+constexpr int kIterations = 2000000;
+
+template <typename Fn>
+double Measure(Fn&& fn) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < kIterations; ++i) {
+        fn();
+    }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() /
+           kIterations * 1e9;
+}
+
+}  // namespace
+
+int main() {
+    rein::log::LogManager::instance().AddLogger("write_path");
+    auto logger = REIN_GET_LOGGER("write_path");
+    auto event = std::make_shared<LogEvent>(rein::log::Level(rein::log::LevelType::kInfo),
+                                            __FILE__, __LINE__, __func__,
+                                            fmt::string_view("user 42 logged in from 10.0.0.1"),
+                                            logger);
+    rein::log::Layout layout(kDefaultLayout);
+
+    // 原来的路径
+    std::FILE* file = std::fopen("/dev/null", "a");
+    if (!file) {
+        std::perror("fopen /dev/null");
+        return 1;
+    }
+    uint64_t old_bytes = 0;
+    double old_ns = Measure([&] {
+        fmt::memory_buffer buffer;
+        layout.format(buffer, event);               // 渲染
+        std::string line = fmt::to_string(buffer);  // 拷贝成 std::string
+        fmt::print(file, "{}", line);               // 拷进 stdio 缓冲区
+        old_bytes += buffer.size() + line.size() * 2;
+    });
+    std::fclose(file);
+
+    // 现在的路径：渲染即写入 Appender 的缓冲区，write(2) 直接取自该缓冲区
+    auto appender = std::make_shared<rein::log::FileAppender>("/dev/null");
+    rein::log::Level level = appender->level();
+    fmt::memory_buffer probe;
+    layout.format(probe, event);
+    double new_ns = Measure([&] { appender->Log(event, level); });
+    uint64_t new_bytes = probe.size() * static_cast<uint64_t>(kIterations);
+
+    std::printf("%zu-byte line, kDefaultLayout, /dev/null\n", probe.size());
+    std::printf("  layout -> std::string -> fmt::print : %6.1f ns, %5.1f bytes copied per event\n",
+                old_ns, static_cast<double>(old_bytes) / kIterations);
+    std::printf("  layout -> appender buffer -> write  : %6.1f ns, %5.1f bytes copied per event\n",
+                new_ns, static_cast<double>(new_bytes) / kIterations);
+    return 0;
+}
@@ -1,12 +1,16 @@
 #ifndef REIN_LOG_APPENDER_H_
 #define REIN_LOG_APPENDER_H_
 
+#include <chrono>
 #include <memory>
 #include <mutex>
 #include <string>
 
+#include <fmt/format.h>
+
 #include "event.h"
 #include "level.h"
+#include "log_constants.h"
 
 // #include "logger.h"
 
@@ -24,10 +28,19 @@ class Logger;
 */
 
 enum class AppenderType {
-    UNKNOWN,  /// < 未知
-    CONSOLE,  ///< 控制台输出器
-    FILE,     ///< 文件输出器
-    NET       ///< 网络输出器
+    UNKNOWN,   /// < 未知
+    CONSOLE,   ///< 控制台输出器
+    FILE,      ///< 文件输出器
+    NET,       ///< 网络输出器
+    MMAP,      ///< 内存映射文件输出器
+    ROTATING,  ///< 滚动文件输出器
+    URING,     ///< io_uring 文件输出器
+    DURABLE,   ///< 持久化（组提交）文件输出器
+    BINARY,    ///< 二进制文件输出器
+    SHARDED,   ///< 按线程分片的文件输出器
+    SHM,       ///< 共享内存环形缓冲区输出器
+    FLIGHT,    ///< 内存飞行记录器
+    DEDUP      ///< 重复消息折叠（包装其他输出器）
 };
 
 class Appender {
@@ -42,6 +55,19 @@ public:
     Appender operator=(const Appender&) = delete;
 
     virtual void Log(const std::shared_ptr<LogEvent> event, Level level) = 0;
+
+    // 把缓冲中的数据交给内核，默认无缓冲
+    virtual void Flush() {}
+
+    /**
+     * @brief 输出已经按本 Appender 的布局渲染好的字节。
+     * 多个 Appender 布局相同时，Logger 只渲染一次并通过该接口共享结果；
+     * 只有 SupportsPreformatted() 返回 true 的 Appender 才会被这样调用，默认退回 Log()。
+     */
+    virtual void Write(const std::shared_ptr<LogEvent>& event, fmt::string_view /*formatted*/) {
+        Log(event, level());
+    }
+    virtual bool SupportsPreformatted() const { return false; }
     // virtual bool ToYamlString() = 0;
 
     template <typename T>
@@ -70,25 +96,56 @@ protected:
     mutable std::mutex mutex_;  // 允许在const中使用
 };
 
-// 具体实现类：文件输出地
-class FileAppender final : public Appender {
+/*
+  具体实现类：文件输出地
+  日志先追加到 Appender 自己的用户态缓冲区，满足任一刷新条件时用 write/writev 交给内核：
+    - 缓冲区达到 buffer_size 字节；
+    - 距上次刷新超过 flush_interval（由 FlushScheduler 后台线程触发，0 表示关闭）；
+    - 事件级别不低于 flush_level；
+    - 显式调用 Flush()。
+*/
+class FileAppender : public Appender {
 public:
     explicit FileAppender(const std::string& name);
     ~FileAppender() override;
     void Log(const std::shared_ptr<LogEvent> event, Level level) override;
-    void ReOpen();
+    void Write(const std::shared_ptr<LogEvent>& event, fmt::string_view formatted) override;
+    bool SupportsPreformatted() const override { return true; }
+    void Flush() override;
+    virtual void ReOpen();
     bool SetFile(std::string name);
 
+    void SetBufferSize(size_t bytes);
+    void SetFlushInterval(std::chrono::milliseconds interval);
+    void SetFlushLevel(LevelType level);
+
+    size_t buffer_size() const;
+    std::chrono::milliseconds flush_interval() const;
+    LevelType flush_level() const;
+
     bool IsOpen() const;
     std::string file() const;
 
-private:
+protected:
+    FileAppender(AppenderType type, const std::string& name);
+
+    // 以追加方式打开文件，失败返回 -1
+    static int OpenFile(const std::string& name);
+
     void Open();
     void Close();
+    void CloseLocked();
+    void FlushLocked();
+    // 追加一条渲染好的日志，按缓冲区大小与 flush_level 决定是否写出；调用方持有 mutex_
+    void AppendLocked(const std::shared_ptr<LogEvent>& event, fmt::string_view formatted);
 
-private:
+protected:
     std::string file_name_;
-    FILE* file_ = nullptr;
+    int fd_ = -1;
+    fmt::memory_buffer buffer_;  // 待写入的日志，受 mutex_ 保护
+    size_t buffer_size_ = kDefaultFileBufferSize;
+    std::chrono::milliseconds flush_interval_{0};
+    LevelType flush_level_ = LevelType::kError;
 };
 
 // 具体实现类：控制台输出地
@@ -97,15 +154,14 @@ public:
     ConsoleAppender();
     explicit ConsoleAppender(const std::string& name = kConsole);
     void Log(const std::shared_ptr<LogEvent> event, Level level) override;
-};
-
-class NetAppender final : public Appender {
-public:
-    explicit NetAppender(const std::string& address);
-    void Log(const std::shared_ptr<LogEvent> event, Level level) override;
+    // 共享的布局结果前后加上本 Appender 自己的颜色
+    void Write(const std::shared_ptr<LogEvent>& event, fmt::string_view formatted) override;
+    bool SupportsPreformatted() const override { return true; }
 
 private:
-    NetAppender() = delete;
+    void WriteLocked();
+
+    fmt::memory_buffer buffer_;  // 复用的输出缓冲区，受 mutex_ 保护
 };
 
 class AppenderFactory {
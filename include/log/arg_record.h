@@ -0,0 +1,219 @@
+#ifndef REIN_LOG_ARG_RECORD_H_
+#define REIN_LOG_ARG_RECORD_H_
+
+#include <fmt/format.h>
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#if __cplusplus >= 201703L
+    #include <string_view>
+#endif
+
+namespace rein {
+namespace log {
+
+// 参数在记录中的类型标签，每个参数编码为：1 字节标签 + 定长值（字符串为 4 字节长度 + 内容）
+enum class ArgType : uint8_t {
+    kNone = 0,
+    kBool,
+    kChar,
+    kInt,      ///< 有符号整数，统一按 int64 存储
+    kUint,     ///< 无符号整数，统一按 uint64 存储
+    kFloat,
+    kDouble,
+    kPointer,  ///< void*
+    kString    ///< 字符串内容直接拷贝进记录
+};
+
+// 参数字节流的内联缓冲区，常见调用不需要堆分配
+constexpr size_t kArgInlineSize = 128;
+using ArgBuffer = fmt::basic_memory_buffer<char, kArgInlineSize>;
+
+namespace detail {
+
+template <typename T>
+inline void PutValue(ArgBuffer &out, ArgType type, T value) {
+    char bytes[1 + sizeof(T)];
+    bytes[0] = static_cast<char>(type);
+    std::memcpy(bytes + 1, &value, sizeof(T));
+    out.append(bytes, bytes + sizeof(bytes));
+}
+
+inline void PutString(ArgBuffer &out, const char *data, size_t size) {
+    PutValue(out, ArgType::kString, static_cast<uint32_t>(size));
+    out.append(data, data + size);
+}
+
+template <typename T>
+struct IsCharLike
+    : std::integral_constant<bool,
+                             std::is_same<T, wchar_t>::value || std::is_same<T, char16_t>::value ||
+                                 std::is_same<T, char32_t>::value> {};
+
+// 默认：无法延迟格式化（自定义类型等），调用方退回到即时格式化
+template <typename T, typename Enable = void>
+struct ArgTraits {
+    static constexpr bool kDeferrable = false;
+};
+
+template <>
+struct ArgTraits<bool> {
+    static constexpr bool kDeferrable = true;
+    static void Encode(ArgBuffer &out, bool value) { PutValue(out, ArgType::kBool, value); }
+};
+
+template <>
+struct ArgTraits<char> {
+    static constexpr bool kDeferrable = true;
+    static void Encode(ArgBuffer &out, char value) { PutValue(out, ArgType::kChar, value); }
+};
+
+template <typename T>
+struct ArgTraits<T,
+                 typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value &&
+                                         !std::is_same<T, char>::value &&
+                                         !IsCharLike<T>::value>::type> {
+    static constexpr bool kDeferrable = true;
+    static void Encode(ArgBuffer &out, T value) {
+        PutValue(out, ArgType::kInt, static_cast<int64_t>(value));
+    }
+};
+
+template <typename T>
+struct ArgTraits<T,
+                 typename std::enable_if<std::is_integral<T>::value && std::is_unsigned<T>::value &&
+                                         !std::is_same<T, bool>::value &&
+                                         !std::is_same<T, char>::value &&
+                                         !IsCharLike<T>::value>::type> {
+    static constexpr bool kDeferrable = true;
+    static void Encode(ArgBuffer &out, T value) {
+        PutValue(out, ArgType::kUint, static_cast<uint64_t>(value));
+    }
+};
+
+template <>
+struct ArgTraits<float> {
+    static constexpr bool kDeferrable = true;
+    static void Encode(ArgBuffer &out, float value) { PutValue(out, ArgType::kFloat, value); }
+};
+
+template <>
+struct ArgTraits<double> {
+    static constexpr bool kDeferrable = true;
+    static void Encode(ArgBuffer &out, double value) { PutValue(out, ArgType::kDouble, value); }
+};
+
+template <typename T>
+struct ArgTraits<T *,
+                 typename std::enable_if<std::is_void<typename std::remove_cv<T>::type>::value>::type> {
+    static constexpr bool kDeferrable = true;
+    static void Encode(ArgBuffer &out, const void *value) {
+        PutValue(out, ArgType::kPointer, value);
+    }
+};
+
+template <typename T>
+struct ArgTraits<
+    T *, typename std::enable_if<std::is_same<typename std::remove_cv<T>::type, char>::value>::type> {
+    static constexpr bool kDeferrable = true;
+    static void Encode(ArgBuffer &out, const char *value) {
+        if (!value) {
+            throw fmt::format_error("string pointer is null");
+        }
+        PutString(out, value, std::strlen(value));
+    }
+};
+
+template <>
+struct ArgTraits<std::string> {
+    static constexpr bool kDeferrable = true;
+    static void Encode(ArgBuffer &out, const std::string &value) {
+        PutString(out, value.data(), value.size());
+    }
+};
+
+template <>
+struct ArgTraits<fmt::string_view> {
+    static constexpr bool kDeferrable = true;
+    static void Encode(ArgBuffer &out, fmt::string_view value) {
+        PutString(out, value.data(), value.size());
+    }
+};
+
+#if __cplusplus >= 201703L
+template <>
+struct ArgTraits<std::string_view> {
+    static constexpr bool kDeferrable = true;
+    static void Encode(ArgBuffer &out, std::string_view value) {
+        PutString(out, value.data(), value.size());
+    }
+};
+#endif
+
+template <typename T>
+using ArgTraitsOf = ArgTraits<typename std::decay<T>::type>;
+
+template <typename... Args>
+struct AllDeferrable;
+
+template <>
+struct AllDeferrable<> : std::true_type {};
+
+template <typename T, typename... Rest>
+struct AllDeferrable<T, Rest...>
+    : std::integral_constant<bool, ArgTraitsOf<T>::kDeferrable && AllDeferrable<Rest...>::value> {};
+
+}  // namespace detail
+
+/*
+  延迟格式化的参数记录。
+  调用线程只保存格式串指针并把参数按值拷贝进一段紧凑的字节流，
+  真正的 fmt 渲染发生在 Appender 取用消息时（异步模式下即后台线程）。
+  格式串必须具有静态存储期（字符串字面量）。
+*/
+class ArgRecord {
+public:
+    ArgRecord() = default;
+    ArgRecord(ArgRecord &&) = default;
+    ArgRecord &operator=(ArgRecord &&) = default;
+
+    template <typename... Args>
+    void Capture(fmt::string_view format, const Args &...args) {
+        static_assert(detail::AllDeferrable<Args...>::value,
+                      "ArgRecord::Capture only accepts deferrable argument types");
+        format_ = format;
+        data_.clear();
+        int expand[] = {0, (detail::ArgTraitsOf<Args>::Encode(data_, args), 0)...};
+        (void)expand;
+    }
+
+    // 直接设置格式串与已编码的参数（回放二进制日志时使用），格式串须在记录使用期间有效
+    void Assign(fmt::string_view format, fmt::string_view data) {
+        format_ = format;
+        data_.clear();
+        data_.append(data.data(), data.data() + data.size());
+    }
+
+    // 解码参数并按格式串渲染，追加到 out
+    void Format(fmt::memory_buffer &out) const;
+
+    bool empty() const { return format_.data() == nullptr; }
+    fmt::string_view format() const { return format_; }
+    fmt::string_view data() const { return fmt::string_view(data_.data(), data_.size()); }
+
+    void clear() {
+        format_ = fmt::string_view();
+        data_.clear();
+    }
+
+private:
+    fmt::string_view format_;
+    ArgBuffer data_;  // 编码后的参数
+};
+
+}  // namespace log
+}  // namespace rein
+
+#endif  // REIN_LOG_ARG_RECORD_H_
@@ -0,0 +1,80 @@
+#ifndef REIN_LOG_ASYNC_WORKER_H_
+#define REIN_LOG_ASYNC_WORKER_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "bounded_queue.hpp"
+#include "event.h"
+#include "log_constants.h"
+
+namespace rein {
+namespace log {
+
+// 队列满时的处理策略
+enum class OverflowPolicy {
+    kBlock,       ///< 阻塞生产者，直到后台线程腾出空位
+    kDropNewest,  ///< 丢弃当前这条日志
+    kDropOldest   ///< 丢弃队列中最旧的一条日志
+};
+
+/*
+  异步输出的后台线程。
+  业务线程只负责构造 LogEvent 并放入有界无锁队列，
+  由后台线程取出后交给 Logger 的 Appender 输出，磁盘/终端的阻塞不再影响调用方。
+  一个 AsyncWorker 可以被多个 Logger 共享（LogManager 的全局异步模式）。
+*/
+class AsyncWorker {
+public:
+    explicit AsyncWorker(size_t capacity = kDefaultAsyncQueueSize,
+                         OverflowPolicy policy = OverflowPolicy::kBlock);
+    ~AsyncWorker();
+
+    AsyncWorker(const AsyncWorker&) = delete;
+    AsyncWorker& operator=(const AsyncWorker&) = delete;
+
+    void Push(std::shared_ptr<LogEvent> event);
+
+    // 阻塞直到调用前已入队的日志全部输出完毕
+    void Flush();
+
+    // 输出剩余日志并结束后台线程；之后的 Push 退化为同步输出
+    void Stop();
+
+    // 因队列满而被丢弃的日志条数
+    uint64_t dropped() const;
+    OverflowPolicy policy() const;
+    size_t capacity() const;
+
+private:
+    void Run();
+    void Drain();
+    void Dispatch(const std::shared_ptr<LogEvent>& event);
+    void Wake();
+
+private:
+    BoundedQueue<std::shared_ptr<LogEvent>> queue_;
+    OverflowPolicy policy_;
+
+    std::atomic<uint64_t> pushed_;   // 成功入队的条数
+    std::atomic<uint64_t> done_;     // 已输出（或被 kDropOldest 丢弃）的条数
+    std::atomic<uint64_t> dropped_;  // 丢弃计数
+    std::atomic<bool> sleeping_;     // 后台线程是否在等待唤醒
+    std::atomic<bool> stop_;
+
+    std::mutex mutex_;
+    bool finished_;                    // Stop() 已完成，受 mutex_ 保护
+    std::condition_variable wake_cv_;  // 唤醒后台线程
+    std::condition_variable done_cv_;  // Flush 等待队列清空
+    std::thread thread_;
+    std::thread::id thread_id_;
+};
+
+}  // namespace log
+}  // namespace rein
+
+#endif  // REIN_LOG_ASYNC_WORKER_H_
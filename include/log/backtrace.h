@@ -0,0 +1,161 @@
+#ifndef REIN_LOG_BACKTRACE_H_
+#define REIN_LOG_BACKTRACE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "arg_record.h"
+#include "clock.h"
+#include "format_string.h"
+#include "level.h"
+#include "log_constants.h"
+
+namespace rein {
+namespace log {
+
+class Logger;
+class BacktraceScope;
+
+namespace detail {
+
+// 当前线程最内层的回溯作用域。没有作用域时 threshold 为 kUnknown，任何级别都不低于它
+struct BacktraceState {
+    LevelType threshold;
+    LevelType trigger;
+    BacktraceScope* scope;
+};
+
+inline BacktraceState& Backtrace() {
+    static thread_local BacktraceState state = {LevelType::kUnknown, LevelType::kUnknown, nullptr};
+    return state;
+}
+
+// 所有线程上存活的回溯作用域个数。为 0 时日志宏不必读取线程局部的 BacktraceState，
+// 未开启的日志语句只付出一次原子级别比较
+inline std::atomic<int>& BacktraceScopes() {
+    static std::atomic<int> scopes{0};
+    return scopes;
+}
+
+}  // namespace detail
+
+/*
+  回溯作用域：在作用域内，当前线程低于 threshold 的日志不格式化、不输出，
+  只把位置、时间戳与参数（同延迟格式化的编码）拷贝进线程内有界的缓冲区，满了覆盖最旧的一条。
+    - 作用域内记录到不低于 trigger 的日志时，先按原顺序输出缓冲的事件，再输出这一条；
+    - 作用域正常结束时缓冲的事件直接丢弃，从不格式化。
+  缓冲不受 Logger 级别限制：Logger 开在 WARN 时 DEBUG 日志照样被缓冲，输出时仍按各 Appender 的级别过滤。
+  作用域可以嵌套，内层作用域有自己的缓冲区，结束后恢复外层。
+  运行期格式串或无法延迟格式化的参数在缓冲时即格式化成文本。
+
+    void Handle(const Request& request) {
+        rein::log::BacktraceScope backtrace;
+        REIN_LOG_DEBUG(logger, "parsed {} headers", request.headers());  // 只进缓冲区
+        ...
+        REIN_LOG_ERROR(logger, "upstream failed: {}", code);  // 先输出上面的 DEBUG，再输出本条
+    }
+*/
+class BacktraceScope {
+public:
+    explicit BacktraceScope(LevelType threshold = LevelType::kWarn,
+                            LevelType trigger = LevelType::kError,
+                            size_t events = kDefaultBacktraceEvents);
+    ~BacktraceScope();
+
+    BacktraceScope(const BacktraceScope&) = delete;
+    BacktraceScope& operator=(const BacktraceScope&) = delete;
+
+    // 编译期格式串且参数都可延迟格式化：只拷贝参数
+    template <typename... Args>
+    void Capture(Logger* logger,
+                 Level level,
+                 const char* file,
+                 uint32_t line,
+                 const char* func,
+                 fmt::string_view format,
+                 const Args&... args) {
+        Entry& entry = Claim(logger, level, file, line, func);
+        entry.format = format;
+        int expand[] = {0, (detail::ArgTraitsOf<Args>::Encode(entry.data, args), 0)...};
+        (void)expand;
+        Commit();
+    }
+
+    // 运行期格式串或含有无法延迟格式化的参数：格式化成文本，作为单个字符串参数保存
+    template <typename S, typename... Args>
+    void CaptureFormatted(Logger* logger,
+                          Level level,
+                          const char* file,
+                          uint32_t line,
+                          const char* func,
+                          const S& fmt,
+                          Args&&... args) {
+        Entry& entry = Claim(logger, level, file, line, func);
+        entry.format = "{}";
+        detail::PutValue(entry.data, ArgType::kString, static_cast<uint32_t>(0));
+        const size_t start = entry.data.size();
+        detail::FormatTo(entry.data, fmt, std::forward<Args>(args)...);
+        // 长度在渲染完成后回填
+        const auto size = static_cast<uint32_t>(entry.data.size() - start);
+        std::memcpy(entry.data.data() + start - sizeof(size), &size, sizeof(size));
+        Commit();
+    }
+
+    // 按记录顺序输出缓冲的事件并清空
+    void Flush();
+    // 丢弃缓冲的事件
+    void Clear();
+
+    size_t size() const { return size_; }
+    size_t capacity() const { return buffer_->entries.size(); }
+    // 缓冲区满时被覆盖的事件数
+    uint64_t dropped() const { return dropped_; }
+
+    // 当前线程最内层的作用域，没有时返回 nullptr
+    static BacktraceScope* Current() { return detail::Backtrace().scope; }
+
+private:
+    struct Entry {
+        Logger* logger;  // 由 Buffer::loggers 保证在作用域内有效
+        Level level;
+        uint32_t line;
+        const char* file;
+        const char* function;
+        Clock::Stamp stamp;
+        fmt::string_view format;  // 静态存储期的格式串
+        ArgBuffer data;           // 编码后的参数
+    };
+
+    // 环形缓冲区，作用域结束后留在线程内给下一个作用域复用，稳态下不分配内存
+    struct Buffer {
+        std::vector<Entry> entries;
+        std::vector<std::shared_ptr<Logger>> loggers;  // 缓冲过事件的 Logger，作用域结束时释放
+    };
+
+    // 取得下一个空闲槽位并填好公共字段，参数区已清空；缓冲区满时先淘汰最旧的一条。
+    // 编码参数抛出异常时不调用 Commit()，槽位不计入
+    Entry& Claim(Logger* logger, Level level, const char* file, uint32_t line, const char* func);
+    void Commit();
+
+private:
+    // 本线程空闲的缓冲区，嵌套的作用域各取一个
+    static thread_local std::vector<std::unique_ptr<Buffer>> spare_buffers_;
+
+    std::unique_ptr<Buffer> buffer_;
+    size_t head_ = 0;  // 最旧一条的下标
+    size_t size_ = 0;
+    uint64_t dropped_ = 0;
+    Logger* last_logger_ = nullptr;
+    detail::BacktraceState previous_;
+};
+
+}  // namespace log
+}  // namespace rein
+
+#endif  // REIN_LOG_BACKTRACE_H_
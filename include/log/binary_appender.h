@@ -0,0 +1,104 @@
+#ifndef REIN_LOG_BINARY_APPENDER_H_
+#define REIN_LOG_BINARY_APPENDER_H_
+
+#include <sys/types.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "appender.h"
+
+namespace rein {
+namespace log {
+
+/*
+  二进制日志文件格式（整数均为 LEB128 变长编码，有符号数先做 zigzag，字符串为长度 + 内容）：
+    文件头  "REINBLOG"
+    记录    1 字节类型 + 内容
+      kHeader  版本、墙上时间纳秒、进程启动后的纳秒；每次打开文件写一次，之后的编号从头开始
+      kSite    调用点编号、级别、日志器名、文件、行号、函数、标志、格式串、参数类型（每个 1 字节 ArgType）
+      kThread  线程编号、内核线程号、pthread_t、线程名；同一编号可被重新定义（线程号复用、改名）
+      kEvent   调用点编号、线程编号、与上一条事件的时间差、参数值（类型由调用点给出，不再逐个标注）
+  参数值：整数与指针为变长整数，bool/char 1 字节，float/double 按原始字节，字符串为长度 + 内容。
+*/
+enum class BinaryRecord : uint8_t { kHeader = 1, kSite, kThread, kEvent };
+
+constexpr char kBinaryLogMagic[8] = {'R', 'E', 'I', 'N', 'B', 'L', 'O', 'G'};
+constexpr uint32_t kBinaryLogVersion = 1;
+constexpr uint8_t kBinarySitePreformatted = 0x01;  // 即时格式化的事件：消息作为唯一的字符串参数
+
+/*
+  二进制文件输出地。
+  不做任何文本渲染：格式串、文件、行号、函数、级别、日志器名按调用点只写一次，
+  每条事件只写调用点编号、时间戳、线程编号和编码后的参数，由 rein_log_decode 离线还原为文本。
+  Logger 开启延迟格式化（SetDeferred(true)）时消息也不会被渲染，收益最大；
+  否则事件里已经渲染好的消息会作为字符串参数写入。
+  Layout 对本 Appender 不生效，解码时再指定；%r 由墙上时间推算，毫秒边界上可能相差 1。
+*/
+class BinaryFileAppender final : public FileAppender {
+public:
+    explicit BinaryFileAppender(const std::string& name);
+
+    void Log(const std::shared_ptr<LogEvent> event, Level level) override;
+    bool SupportsPreformatted() const override { return false; }
+
+    // 重新打开后写入新的文件头，字典从头开始
+    void ReOpen() override;
+
+private:
+    struct SiteKey {
+        const char* format;
+        const char* file;
+        const char* function;
+        const Logger* logger;
+        uint32_t line;
+        LevelType level;
+
+        bool operator==(const SiteKey& other) const {
+            return format == other.format && file == other.file && function == other.function &&
+                   logger == other.logger && line == other.line && level == other.level;
+        }
+    };
+
+    struct SiteKeyHash {
+        size_t operator()(const SiteKey& key) const;
+    };
+
+    struct Site {
+        uint32_t id;
+        std::weak_ptr<Logger> logger;  // 日志器销毁后地址可能被复用，过期的调用点重新定义
+        std::string types;             // 参数类型签名
+        int next = -1;                 // 同一位置、不同参数类型（模板函数内的日志）的下一个调用点
+    };
+
+    struct Thread {
+        uint32_t id;
+        pthread_t pthread_id;
+        char name[16];
+    };
+
+    // 校验或写入文件头，并写一条 kHeader；调用方持有 mutex_
+    void StartLocked();
+    uint32_t SiteLocked(const LogEvent& event, fmt::string_view types);
+    uint32_t ThreadLocked(const ThreadInfo& thread);
+
+private:
+    std::unordered_map<SiteKey, int, SiteKeyHash> site_index_;  // 以下均受 mutex_ 保护
+    std::vector<Site> sites_;
+    SiteKey last_key_{};          // 上一条事件的调用点
+    int last_site_ = -1;
+    std::unordered_map<pid_t, Thread> threads_;
+    uint32_t next_thread_ = 0;
+    uint64_t last_wall_ = 0;      // 上一条事件的墙上时间，事件只记差值
+    fmt::memory_buffer record_;   // 正在编码的记录
+    fmt::memory_buffer types_;    // 当前事件的参数类型签名
+    fmt::memory_buffer values_;   // 当前事件编码后的参数值
+};
+
+}  // namespace log
+}  // namespace rein
+
+#endif  // REIN_LOG_BINARY_APPENDER_H_
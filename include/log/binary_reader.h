@@ -0,0 +1,82 @@
+#ifndef REIN_LOG_BINARY_READER_H_
+#define REIN_LOG_BINARY_READER_H_
+
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "event.h"
+
+namespace rein {
+namespace log {
+
+class Logger;
+
+/*
+  读取 BinaryFileAppender 写出的文件，把每条记录还原为 LogEvent，交给任意 Layout 渲染。
+  事件的文件名、函数名、格式串引用读取器内的字典，只保证在下一次 Next() 之前有效。
+  日志器按名字从 LogManager 取得（不存在时创建），以便布局中的 %c 照常工作。
+  写入方崩溃时文件末尾可能有半条记录：Next() 返回空并置 truncated()。
+*/
+class BinaryLogReader {
+public:
+    // 打开失败或不是二进制日志时抛出 std::runtime_error
+    explicit BinaryLogReader(const std::string& file);
+    ~BinaryLogReader();
+
+    BinaryLogReader(const BinaryLogReader&) = delete;
+    BinaryLogReader& operator=(const BinaryLogReader&) = delete;
+
+    // 下一条事件，读完返回 nullptr；记录损坏时抛出 std::runtime_error
+    std::shared_ptr<LogEvent> Next();
+
+    bool truncated() const { return truncated_; }
+
+private:
+    struct Site {
+        bool defined = false;
+        Level level;
+        std::shared_ptr<Logger> logger;
+        std::string file;
+        uint32_t line = 0;
+        std::string function;
+        uint8_t flags = 0;
+        std::string format;
+        std::string types;
+    };
+
+    struct Cursor;
+
+    // 解析 [pos_, end_) 中的一条记录；数据不完整时返回 false 且不移动 pos_
+    bool Parse(std::shared_ptr<LogEvent>& event);
+    void ParseSite(Cursor& cursor);
+    void ParseThread(Cursor& cursor);
+    std::shared_ptr<LogEvent> ParseEvent(Cursor& cursor);
+    // 读入更多数据，文件已读完返回 false
+    bool Fill();
+
+private:
+    std::string file_name_;
+    std::FILE* file_ = nullptr;
+    std::vector<char> data_;
+    size_t pos_ = 0;
+    size_t end_ = 0;
+    bool eof_ = false;
+    bool truncated_ = false;
+
+    std::vector<Site> sites_;
+    std::vector<std::shared_ptr<const ThreadInfo>> threads_;
+    uint64_t base_wall_ = 0;     // 当前段 kHeader 中的墙上时间
+    uint64_t base_elapsed_ = 0;  // 当前段 kHeader 中的启动后纳秒数
+    uint64_t last_wall_ = 0;
+    fmt::memory_buffer args_;    // 还原为 ArgRecord 定长编码的参数
+};
+
+}  // namespace log
+}  // namespace rein
+
+#endif  // REIN_LOG_BINARY_READER_H_
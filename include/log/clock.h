@@ -0,0 +1,111 @@
+#ifndef REIN_LOG_CLOCK_H_
+#define REIN_LOG_CLOCK_H_
+
+#include <time.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include "log_constants.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+    #include <x86intrin.h>  // for __rdtsc
+    #define REIN_LOG_HAS_TSC 1
+#else
+    #define REIN_LOG_HAS_TSC 0
+#endif
+
+namespace rein {
+namespace log {
+
+// LogEvent 时间戳的来源
+enum class ClockType : uint8_t {
+    kRealtime,        ///< CLOCK_MONOTONIC 加上每秒对齐一次的墙上时间偏移，精确到纳秒
+    kRealtimeCoarse,  ///< CLOCK_REALTIME_COARSE，精度为一个 tick（通常 1~4ms），开销最低
+    kTsc              ///< rdtsc 计数，按墙上时间校准，只在格式化时换算
+};
+
+/*
+  时间戳采样。
+  热路径上只读一个原子的时钟类型并取一次 vDSO 时间（kRealtimeCoarse 为两次粗粒度读取），
+  kTsc 模式下事件只保存原始计数，由 Appender 格式化时再换算成墙上时间。
+  kRealtime 与 kTsc 每隔 kClockReanchorNs 重新对齐一次 CLOCK_REALTIME，NTP 的调整在一秒内生效。
+  elapse 一律基于单调时钟，不受 NTP 调整影响。
+*/
+class Clock {
+public:
+    // 一次采样的结果，含义取决于 type
+    struct Stamp {
+        ClockType type;
+        uint64_t wall;  // kTsc：原始计数；其余：Unix 纳秒
+        uint64_t mono;  // kTsc：未使用；其余：单调时钟纳秒
+    };
+
+    /**
+     * @brief 切换时钟来源。
+     * kTsc 会在此处做一次约 10ms 的初始校准，之后在换算时每秒重新对齐；
+     * CPU 不支持不变 TSC（或非 x86）时退回 kRealtime。
+     * @return 实际生效的时钟类型
+     */
+    static ClockType Set(ClockType type);
+    static ClockType type() { return type_.load(std::memory_order_relaxed); }
+
+    static Stamp Now() {
+        Stamp stamp;
+        stamp.type = type();
+        switch (stamp.type) {
+#if REIN_LOG_HAS_TSC
+            case ClockType::kTsc:
+                stamp.wall = __rdtsc();
+                stamp.mono = 0;
+                break;
+#endif
+            case ClockType::kRealtimeCoarse:
+                stamp.wall = Read(CLOCK_REALTIME_COARSE);
+                stamp.mono = Read(CLOCK_MONOTONIC_COARSE);
+                break;
+            case ClockType::kRealtime:
+            default:
+                // 只读一次单调时钟，墙上时间由缓存的偏移换算，偏移过期时（每秒一次）重新对齐
+                stamp.type = ClockType::kRealtime;
+                stamp.mono = Read(CLOCK_MONOTONIC);
+                if (stamp.mono >= offset_expiry_.load(std::memory_order_acquire)) {
+                    Reanchor(stamp.mono);
+                }
+                stamp.wall = stamp.mono + wall_offset_.load(std::memory_order_relaxed);
+                break;
+        }
+        return stamp;
+    }
+
+    // 由墙上时间与距进程启动的纳秒数构造采样，用于回放其他进程记录的事件
+    static Stamp Restore(uint64_t wall_ns, uint64_t elapsed_ns);
+
+    // 换算为墙上时间
+    static std::chrono::system_clock::time_point ToTimePoint(const Stamp& stamp);
+
+    // 距离进程启动（日志库初始化）的单调纳秒数
+    static uint64_t ElapsedNs(const Stamp& stamp);
+
+    // clock_gettime 的纳秒形式
+    static uint64_t Read(clockid_t id) {
+        struct timespec ts;
+        clock_gettime(id, &ts);
+        return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<uint64_t>(ts.tv_nsec);
+    }
+
+private:
+    // 重新测量 CLOCK_REALTIME 与 CLOCK_MONOTONIC 的差值，mono 为触发时读到的单调时间
+    static void Reanchor(uint64_t mono);
+
+private:
+    static std::atomic<ClockType> type_;
+    static std::atomic<uint64_t> wall_offset_;    // 墙上时间 - 单调时间（模 2^64）
+    static std::atomic<uint64_t> offset_expiry_;  // 单调时间超过它时重新对齐
+};
+
+}  // namespace log
+}  // namespace rein
+
+#endif  // REIN_LOG_CLOCK_H_
@@ -0,0 +1,76 @@
+#ifndef REIN_LOG_DEDUP_APPENDER_H_
+#define REIN_LOG_DEDUP_APPENDER_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "appender.h"
+#include "log_constants.h"
+
+namespace rein {
+namespace log {
+
+/*
+  重复消息折叠：包在另一个 Appender 外面，按 级别 + 调用点 + 消息正文 的散列识别重复的日志。
+  记住最近出现的 window 条不同消息，其中任何一条再次出现时不写出，只计数；
+  window 为 1 时只折叠连续的重复，更大时几条消息交替刷屏（多个线程各报各的错）也能折叠。
+  被折叠的重复在以下时机汇总成一行写出，例如 "last message repeated 12345 times in 2.1s"：
+    - 这条消息被新的消息挤出记录表时（window 为 1 即下一条不同的消息之前）；
+    - 每隔 summary_interval（由 FlushScheduler 定时触发，只写汇总行，
+      被包装 Appender 的缓冲仍按它自己的刷新策略写出）；
+    - Flush() 与析构时，随后刷新被包装的 Appender。
+  汇总行沿用原消息的级别、位置与日志器，经被包装 Appender 的布局输出。
+*/
+class DedupAppender final : public Appender {
+public:
+    // 名字与被包装的 Appender 相同；summary_interval 为 0 表示不定时汇总
+    explicit DedupAppender(std::shared_ptr<Appender> target,
+                           size_t window = kDefaultDedupWindow,
+                           std::chrono::milliseconds summary_interval =
+                               std::chrono::milliseconds(kDefaultDedupSummaryMs));
+    ~DedupAppender() override;
+
+    void Log(const std::shared_ptr<LogEvent> event, Level level) override;
+    // 写出所有待汇总的重复计数，再刷新被包装的 Appender
+    void Flush() override;
+
+    const std::shared_ptr<Appender>& target() const { return target_; }
+    // 累计被折叠（未写出）的日志条数
+    uint64_t suppressed() const { return suppressed_.load(std::memory_order_relaxed); }
+
+private:
+    struct Entry {
+        uint64_t hash = 0;
+        std::shared_ptr<LogEvent> event;  // 第一次出现时写出的事件
+        uint64_t repeats = 0;             // 上次汇总以来的重复次数
+        uint64_t first_ns = 0;            // 本轮计数的起点（单调时钟）
+        uint64_t last_ns = 0;             // 最近一次重复
+        uint64_t used = 0;                // 最近一次出现的序号，记录表满时淘汰最小的
+        uint64_t written = 0;             // event 写出时的写出序号
+    };
+
+    static uint64_t Hash(const LogEvent& event);
+    static bool SameMessage(const LogEvent& lhs, const LogEvent& rhs);
+
+    // 写出一条汇总并清零计数；调用方持有 mutex_
+    void SummarizeLocked(Entry& entry);
+    void SummarizeAllLocked();
+    // 定时汇总：只写出汇总行，不刷新被包装的 Appender
+    void Summarize();
+
+private:
+    std::shared_ptr<Appender> target_;
+    std::vector<Entry> entries_;
+    uint64_t tick_ = 0;
+    uint64_t written_ = 0;  // 写给被包装 Appender 的条数，与 Entry::written 相等即最近写出的是它
+    std::chrono::milliseconds summary_interval_;
+    std::atomic<uint64_t> suppressed_{0};
+};
+
+}  // namespace log
+}  // namespace rein
+
+#endif  // REIN_LOG_DEDUP_APPENDER_H_
@@ -0,0 +1,93 @@
+#ifndef REIN_LOG_DURABLE_APPENDER_H_
+#define REIN_LOG_DURABLE_APPENDER_H_
+
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "appender.h"
+#include "log_constants.h"
+
+namespace rein {
+namespace log {
+
+// 持久化凭据：记录写入后的累计逻辑长度（跨 ReOpen 连续），持久化到该长度时对应的记录即已落盘
+using SyncTicket = uint64_t;
+
+enum class SyncMode : uint8_t {
+    kBlocking,  ///< Log() 返回前记录已经落盘
+    kTicket     ///< Log() 立即返回，调用方用 Ticket() / Wait() 自行决定何时等待
+};
+
+/*
+  持久化文件输出地，用于审计等要求"返回即落盘"的日志。
+  并发的等待者组提交：同一时刻只有一个线程执行 fdatasync，其余线程等待；
+  一次 fdatasync 确认它开始前写入的所有记录，吞吐随并发线程数增长，而不是每条日志一次同步。
+  文件按 preallocate_size 用 fallocate 预先扩展，写入不再改变文件大小，
+  fdatasync 不必同时提交元数据；正常关闭时截断到实际长度，崩溃后重新打开时去掉末尾的预分配空间。
+  因此运行期间文件末尾是尚未使用的 NUL 字节，tail -f 等工具会看到它们。
+  异步 Logger 下 Log() 在后台线程执行：kBlocking 阻塞的是后台线程，取凭据前应先 Logger::Flush()。
+  ReOpen()（如 logrotate 之后）先让旧文件落盘并截掉预分配的尾部，再从新文件的实际末尾续写；
+  凭据跨文件连续增长，重新打开前取得的凭据仍然有效。
+*/
+class DurableFileAppender final : public FileAppender {
+public:
+    explicit DurableFileAppender(const std::string& name, SyncMode mode = SyncMode::kBlocking,
+                                 size_t preallocate_size = kDefaultPreallocateSize);
+    ~DurableFileAppender() override;
+
+    void Log(const std::shared_ptr<LogEvent> event, Level level) override;
+    void Write(const std::shared_ptr<LogEvent>& event, fmt::string_view formatted) override;
+    void ReOpen() override;
+
+    // 覆盖到目前为止写入的全部记录的凭据
+    SyncTicket Ticket() const;
+
+    // 阻塞直到 ticket 之前的记录落盘；fdatasync 失败时返回 false
+    bool Wait(SyncTicket ticket);
+    bool IsDurable(SyncTicket ticket) const;
+
+    // 等价于 Wait(Ticket())
+    bool Sync();
+
+    void SetSyncMode(SyncMode mode);
+    SyncMode sync_mode() const;
+
+private:
+    SyncTicket AppendRecordLocked(const std::shared_ptr<LogEvent>& event,
+                                  fmt::string_view formatted);
+    void PreallocateLocked(uint64_t end);
+    // 接管刚打开的 fd：去掉 O_APPEND、清理崩溃留下的预分配空间并定位到末尾
+    void AttachLocked();
+    void TruncateLocked();
+    void Recover();
+    // 结束一轮 fdatasync 并唤醒等待者；调用方持有 sync_mutex_
+    void CompleteSyncLocked(int ret, int err, uint64_t target);
+    // ticket 落在某个失败区间内；调用方持有 sync_mutex_
+    bool FailedLocked(SyncTicket ticket) const;
+
+private:
+    SyncMode mode_;
+    const size_t preallocate_size_;
+    bool preallocate_ = true;    // 文件系统不支持 fallocate 时关闭
+    uint64_t written_ = 0;       // 文件的逻辑长度（含缓冲中的部分），受 mutex_ 保护
+    uint64_t base_ = 0;          // 凭据 = base_ + written_，ReOpen 时调整使凭据连续，受 mutex_ 保护
+    uint64_t allocated_ = 0;     // 已预分配到的文件大小，受 mutex_ 保护
+    fmt::memory_buffer record_;  // Log() 渲染单条日志用，受 mutex_ 保护
+
+    mutable std::mutex sync_mutex_;
+    std::condition_variable sync_cv_;
+    uint64_t synced_ = 0;        // 已经落盘的逻辑长度
+    // fdatasync 失败的凭据区间 (begin, end]，按位置递增；中间成功确认过的凭据不在其中
+    std::vector<std::pair<uint64_t, uint64_t>> failed_;
+    bool syncing_ = false;       // 有线程正在执行 fdatasync
+};
+
+}  // namespace log
+}  // namespace rein
+
+#endif  // REIN_LOG_DURABLE_APPENDER_H_
@@ -1,30 +1,85 @@
 #ifndef REIN_LOG_EVENT_H_
 #define REIN_LOG_EVENT_H_
 
-#include <pthread.h>      // Linux 线程接口
-#include <sys/syscall.h>  // for SYS_gettid
+#include <pthread.h>  // Linux 线程接口
+#include <sys/types.h>
 
+#include <fmt/format.h>
+
+#include <chrono>
 #include <cstdio>
 #include <memory>
 #include <string>
-#include <chrono>
+#include <utility>
 
+#include "arg_record.h"
+#include "clock.h"
+#include "format_string.h"
 #include "level.h"
+#include "thread_info.h"
 
 namespace rein {
 namespace log {
 
 class Logger;
 
+/*
+  一条日志事件。
+  消息直接写入事件内的内联缓冲区（fmt::memory_buffer，超长时才退回堆上），
+  配合 PoolAllocator 分配，稳态下同步输出路径不产生堆分配。
+  成员按访问频率排列：布局格式化常用的字段集中在对象开头。
+*/
 class LogEvent {
 public:
+    // 消息由调用方随后通过 Format()/Capture() 写入
+    LogEvent(Level level,
+             const char* file,
+             uint32_t line,
+             const char* function,
+             std::shared_ptr<Logger> logger);
+
+    LogEvent(Level level,
+             const char* file,
+             uint32_t line,
+             const char* function,
+             fmt::string_view message,
+             std::shared_ptr<Logger> logger);
+
+    // 回放已记录的事件：时间戳与线程身份由调用方给出，不取当前值
     LogEvent(Level level,
              const char* file,
              uint32_t line,
              const char* function,
-             std::string message,
+             const Clock::Stamp& stamp,
+             std::shared_ptr<const ThreadInfo> thread,
              std::shared_ptr<Logger> logger);
 
+    LogEvent(const LogEvent&) = delete;
+    LogEvent& operator=(const LogEvent&) = delete;
+
+    // 即时格式化：直接渲染进事件自带的缓冲区
+    template <typename S, typename... Args>
+    void Format(const S& fmt, Args&&... args) {
+        message_.clear();
+        detail::FormatTo(message_, fmt, std::forward<Args>(args)...);
+        formatted_ = true;
+    }
+
+    // 延迟格式化：只保存参数记录，消息在第一次调用 message() 时渲染
+    template <typename... Args>
+    void Capture(fmt::string_view format, const Args&... args) {
+        record_.Capture(format, args...);
+        message_.clear();
+        formatted_ = false;
+    }
+
+    // 回放用：设置已编码的参数记录，消息在第一次调用 message() 时渲染
+    void Assign(fmt::string_view format, fmt::string_view data) {
+        record_.Assign(format, data);
+        message_.clear();
+        formatted_ = false;
+    }
+
     // 获取日志级别
     Level level() const { return level_; }
 
@@ -34,45 +89,61 @@ public:
     // 获取行号
     uint32_t line() const { return line_; }
 
-    // 获取程序启动到当前的毫秒数
-    uint32_t elapse() const { return elapse_; }
+    // 获取程序启动到当前的毫秒数（单调时钟）
+    uint64_t elapse() const { return elapse_ns() / 1000000; }
+
+    // 获取程序启动到当前的纳秒数（单调时钟，不受 NTP 调整影响）
+    uint64_t elapse_ns() const { return Clock::ElapsedNs(stamp_); }
 
     // 获取pthread线程ID（用户态）
-    pthread_t pthread_id() const { return pthread_id_; }
+    pthread_t pthread_id() const { return thread_->pthread_id(); }
+
+    // 获取内核线程ID（gettid）
+    pid_t tid() const { return thread_->tid(); }
 
     // 获取协程ID
     uint64_t fiber_id() const { return fiber_id_; }
 
     // 获取线程名
-    const std::string& thread_name() const { return thread_name_; }
+    const char* thread_name() const { return thread_->name(); }
+
+    // 获取产生该事件的线程的身份信息
+    const ThreadInfo& thread_info() const { return *thread_; }
 
     // 获取函数名
     const char* function() const { return function_; }
 
-    // 获取日志消息内容
-    const std::string& message() const { return message_; }
+    // 获取日志消息内容，指向事件内部的缓冲区，生命周期与事件相同
+    fmt::string_view message() const;
+
+    // 获取延迟格式化的参数记录（即时格式化的事件为空）
+    const ArgRecord& record() const { return record_; }
 
-    // 获取日志产生的时间戳
-    const std::chrono::system_clock::time_point& timestamp() const { return timestamp_; }
+    // 获取日志产生的时间戳（kTsc 时钟在此时才换算为墙上时间）
+    std::chrono::system_clock::time_point timestamp() const { return Clock::ToTimePoint(stamp_); }
+
+    // 获取原始的时钟采样
+    const Clock::Stamp& stamp() const { return stamp_; }
 
     // 获取关联的日志器
-    std::shared_ptr<Logger> logger() const { return logger_; }
+    const std::shared_ptr<Logger>& logger() const { return logger_; }
 
 private:
-private:
+    // 热字段：布局格式化几乎每条都会读取
     Level level_;                                      // 日志等级
-    const char* file_;                                 // 文件名（来自 __FILE__）
     uint32_t line_;                                    // 行号（来自 __LINE__）
-    uint32_t elapse_;                                  // 程序启动到现在的毫秒数
-    uint64_t fiber_id_;                                // 协程ID
-    std::string thread_name_;                          // 线程名
-    pthread_t pthread_id_;                             // pthread 线程ID（用户态）
+    const char* file_;                                 // 文件名（来自 __FILE__）
     const char* function_;                             // 函数名（__func__）
-    std::string message_;                              // 日志消息内容
-    std::chrono::system_clock::time_point timestamp_;  // 精确时间戳
+    Clock::Stamp stamp_;                               // 时钟采样（墙上时间 + 单调时间）
+    std::shared_ptr<Logger> logger_;                   // 关联的日志器
+    std::shared_ptr<const ThreadInfo> thread_;         // 线程身份（线程内缓存）
+    uint64_t fiber_id_;                                // 协程ID
+    mutable bool formatted_;                           // message_ 是否已渲染
 
-    std::shared_ptr<Logger> logger_;  // 关联的日志器
+    // 冷字段：消息正文与延迟格式化的参数
+    mutable fmt::memory_buffer message_;  // 日志消息内容（内联存储）
+    ArgRecord record_;                    // 延迟格式化的参数
 };
 }  // namespace log
 }  // namespace rein
-#endif  // REIN_LOG_EVENT_H_
\ No newline at end of file
+#endif  // REIN_LOG_EVENT_H_
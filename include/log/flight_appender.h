@@ -0,0 +1,92 @@
+#ifndef REIN_LOG_FLIGHT_APPENDER_H_
+#define REIN_LOG_FLIGHT_APPENDER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "appender.h"
+#include "log_constants.h"
+
+namespace rein {
+namespace log {
+
+/*
+  飞行记录器：在内存中保留最近的 events 条日志，平时不做任何 I/O，需要时一次性写出。
+  写出的时机：
+    - 记录到不低于 dump_level（默认 FATAL）的事件；
+    - 显式调用 Dump()；
+    - 安装 InstallSignalHandlers() 后进程收到 SIGSEGV/SIGABRT/SIGBUS/SIGFPE/SIGILL。
+  事件存放在构造时一次性映射并预先缺页的固定大小槽位中，写入不加锁：fetch_add 取得序号后独占对应槽位，
+  只复制时间戳、级别、位置、线程号、日志器名与消息，不经过 Layout；超出槽位的消息被截断。
+  写出时按固定格式逐条渲染，只用栈上的缓冲区与 write()，可以在信号处理函数中调用。
+  典型用法是 Logger 开到 DEBUG，其他 Appender 用 SetLevel() 保持在 WARN，只有本 Appender 接收全部事件。
+*/
+class FlightRecorderAppender final : public Appender {
+public:
+    // dump_file 为空时写到 stderr；文件在写出时才以追加方式打开
+    explicit FlightRecorderAppender(const std::string& dump_file = "",
+                                    size_t events = kDefaultFlightEvents,
+                                    size_t slot_size = kDefaultFlightSlotSize);
+    ~FlightRecorderAppender() override;
+
+    void Log(const std::shared_ptr<LogEvent> event, Level level) override;
+
+    // 写出当前保留的事件，返回写出的条数
+    size_t Dump();
+    // 写到指定的描述符；异步信号安全
+    size_t DumpTo(int fd);
+
+    void SetDumpLevel(LevelType level);
+
+    size_t capacity() const { return count_; }
+    size_t slot_size() const { return slot_size_; }
+    // 已记录的事件总数
+    uint64_t recorded() const { return next_.load(std::memory_order_relaxed); }
+    // 槽位仍被更早的写入者占用而放弃的事件数
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+    // 按总字节数换算保留的事件数
+    static size_t EventsForBytes(size_t bytes, size_t slot_size = kDefaultFlightSlotSize);
+
+    // 写出所有存活的飞行记录器；异步信号安全，可在自己的信号处理函数中调用
+    static size_t DumpAll();
+
+    // 为致命信号安装处理函数：写出所有飞行记录器，再交还给原来的处理方式；重复调用无效果
+    static void InstallSignalHandlers();
+
+private:
+    // 槽位头部，之后紧跟日志器名与消息
+    struct Slot {
+        std::atomic<uint64_t> seq;  // 0 空闲；2 * 序号 + 1 写入中；2 * 序号 + 2 已写完
+        uint64_t wall_ns;
+        const char* file;
+        uint32_t line;
+        int32_t tid;
+        uint8_t level;
+        uint8_t logger_size;
+        uint16_t message_size;
+    };
+
+    Slot* SlotAt(uint64_t index) const {
+        return reinterpret_cast<Slot*>(slots_ + (index & (count_ - 1)) * slot_size_);
+    }
+    void Record(const LogEvent& event);
+
+private:
+    std::string dump_file_;
+    size_t count_;      // 槽位数，2 的幂
+    size_t slot_size_;  // 单个槽位的字节数，64 的倍数
+    char* slots_ = nullptr;
+    std::atomic<uint64_t> next_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<LevelType> dump_level_{LevelType::kFatal};
+    std::atomic<long> utc_offset_{0};    // 本地时间与 UTC 的秒差，信号处理中不能调用 localtime_r
+    std::atomic<bool> dumping_{false};   // 同一时刻只有一个写出者
+};
+
+}  // namespace log
+}  // namespace rein
+
+#endif  // REIN_LOG_FLIGHT_APPENDER_H_
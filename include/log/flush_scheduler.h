@@ -0,0 +1,58 @@
+#ifndef REIN_LOG_FLUSH_SCHEDULER_H_
+#define REIN_LOG_FLUSH_SCHEDULER_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace rein {
+namespace log {
+
+class Appender;
+
+/*
+  定时刷新缓冲的后台线程，所有按时间刷新的 Appender 共用一个。
+  第一次 Register 时才启动线程；Appender 析构前必须 Unregister，
+  Unregister 返回后保证不会再有针对它的 Flush() 调用。
+*/
+class FlushScheduler {
+public:
+    static FlushScheduler& instance();
+
+    // 每隔 interval 调用一次 appender->Flush()；重复注册会更新间隔
+    void Register(Appender* appender, std::chrono::milliseconds interval);
+    // 同上，但到期时调用 task 而不是 Flush()，供只需定时做部分工作的 Appender 使用；
+    // 仍以 appender 为键，Unregister 的保证同样适用于 task
+    void Register(Appender* appender,
+                  std::chrono::milliseconds interval,
+                  std::function<void()> task);
+    void Unregister(Appender* appender);
+
+private:
+    FlushScheduler() = default;
+    FlushScheduler(const FlushScheduler&) = delete;
+    FlushScheduler& operator=(const FlushScheduler&) = delete;
+
+    void Run();
+
+private:
+    struct Entry {
+        Appender* appender;
+        std::chrono::milliseconds interval;
+        std::chrono::steady_clock::time_point due;
+        std::function<void()> task;  // 为空时调用 appender->Flush()
+    };
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::vector<Entry> entries_;
+    bool started_ = false;  // 后台线程是否已启动（线程随进程退出，不做 join）
+};
+
+}  // namespace log
+}  // namespace rein
+
+#endif  // REIN_LOG_FLUSH_SCHEDULER_H_
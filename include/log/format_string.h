@@ -0,0 +1,68 @@
+#ifndef REIN_LOG_FORMAT_STRING_H_
+#define REIN_LOG_FORMAT_STRING_H_
+
+#include <fmt/compile.h>
+#include <fmt/format.h>
+
+#include <iterator>  // for std::back_inserter
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "arg_record.h"
+
+/**
+ * @brief 将字符串字面量包装为编译期格式串。
+ * 参数个数/类型与格式串不匹配时直接编译失败；
+ * C++17 及以上使用 FMT_COMPILE 预编译格式串，运行时不再解析；C++14 退化为 FMT_STRING，只做编译期检查。
+ * REIN_LOG_* 宏默认对格式串使用该宏，因此宏的格式串必须是字面量。
+ */
+#define REIN_FMT(s) FMT_COMPILE(s)
+
+namespace rein {
+namespace log {
+namespace detail {
+
+/*
+  REIN_FMT / FMT_STRING / FMT_COMPILE 生成的都是空类，格式串编码在类型里，
+  并且可以转换为 string_view —— 据此区分编译期格式串与运行期字符串。
+*/
+template <typename S>
+struct IsStaticFormat
+    : std::integral_constant<bool,
+                             std::is_class<S>::value && std::is_empty<S>::value &&
+                                 std::is_constructible<fmt::string_view, const S &>::value> {};
+
+// 只有编译期格式串（静态存储期）且参数均可捕获时才能延迟格式化
+template <typename S, typename... Args>
+struct CanDefer
+    : std::integral_constant<bool, IsStaticFormat<S>::value && AllDeferrable<Args...>::value> {};
+
+template <typename S, typename std::enable_if<IsStaticFormat<S>::value, int>::type = 0>
+fmt::string_view ToStringView(const S &fmt) {
+    return fmt::string_view(fmt);
+}
+
+// 编译期格式串：由 fmt 做编译期检查（C++17 起使用预编译的格式化代码），结果追加到 out
+template <typename Buffer,
+          typename S,
+          typename... Args,
+          typename std::enable_if<IsStaticFormat<S>::value, int>::type = 0>
+void FormatTo(Buffer &out, const S &fmt, Args &&...args) {
+    fmt::format_to(std::back_inserter(out), fmt, std::forward<Args>(args)...);
+}
+
+// 运行期字符串（std::string、const char* 等）：运行时解析
+template <typename Buffer,
+          typename S,
+          typename... Args,
+          typename std::enable_if<!IsStaticFormat<S>::value, int>::type = 0>
+void FormatTo(Buffer &out, const S &fmt, Args &&...args) {
+    fmt::format_to(std::back_inserter(out), fmt::runtime(fmt), std::forward<Args>(args)...);
+}
+
+}  // namespace detail
+}  // namespace log
+}  // namespace rein
+
+#endif  // REIN_LOG_FORMAT_STRING_H_
@@ -1,18 +1,13 @@
 #ifndef REIN_LOG_FORMATTERS_H_
 #define REIN_LOG_FORMATTERS_H_
+#include <cstdint>
+#include <ctime>
+
 #include "layout.h"
 
 namespace rein {
 namespace log {
 
-// 日志器名称
-class NameFormatter final : public Layout::FormatterItem {
-public:
-    explicit NameFormatter() = default;
-
-    void format(fmt::memory_buffer &buffer, const std::shared_ptr<LogEvent> &event) override;
-};
-
 /**
 时间戳
 直接使用fmt原生占位符支持
@@ -23,7 +18,10 @@ public:
 %M：分钟（45）
 %S：秒（30）
 其他占位符：%A（星期全名）、%b（月份缩写）
-新增：%f 毫秒数
+新增：%f（或 %3f）毫秒，%6f 微秒，%9f 纳秒（每个格式串最多一个）
+
+秒级以上的部分每秒只渲染一次并缓存在 thread_local 中，同一秒内的日志只改写亚秒位；
+本地时间由自行维护的 UTC 偏移换算，localtime_r 每个线程每 15 分钟才调用一次。
 */
 class DateTimeFormatter final : public Layout::FormatterItem {
 public:
@@ -32,80 +30,19 @@ public:
     void format(fmt::memory_buffer &buffer, const std::shared_ptr<LogEvent> &event) override;
 
 private:
-    std::string format_;
-};
-
-class FileNameFormatter final : public Layout::FormatterItem {
-public:
-    explicit FileNameFormatter() = default;
+    struct Cache;
 
-    void format(fmt::memory_buffer &buffer, const std::shared_ptr<LogEvent> &event) override;
+    // 渲染 seconds 所在这一秒的前缀/后缀到缓存
+    void Render(Cache &cache, std::time_t seconds) const;
 
 private:
-    std::string name_;
-};
-
-// 行数
-class LineFormatter final : public Layout::FormatterItem {
-public:
-    explicit LineFormatter() = default;
-    void format(fmt::memory_buffer &buffer, const std::shared_ptr<LogEvent> &event) override;
-};
-
-// 内容
-class MessageFormatter final : public Layout::FormatterItem {
-public:
-    explicit MessageFormatter() = default;
-    void format(fmt::memory_buffer &buffer, const std::shared_ptr<LogEvent> &event) override;
-};
-
-// 换行
-class NewLineFormatter final : public Layout::FormatterItem {
-public:
-    explicit NewLineFormatter() = default;
-    void format(fmt::memory_buffer &buffer, const std::shared_ptr<LogEvent> &event) override;
-};
-
-// 线程id
-class ThreadIdFormatter final : public Layout::FormatterItem {
-public:
-    explicit ThreadIdFormatter() = default;
-    void format(fmt::memory_buffer &buffer, const std::shared_ptr<LogEvent> &event) override;
-};
-
-class ThreadNameFormatter final : public Layout::FormatterItem {
-public:
-    explicit ThreadNameFormatter() = default;
-    void format(fmt::memory_buffer &buffer, const std::shared_ptr<LogEvent> &event) override;
-};
-
-class LevelFormatter final : public Layout::FormatterItem {
-public:
-    explicit LevelFormatter() = default;
-    void format(fmt::memory_buffer &buffer, const std::shared_ptr<LogEvent> &event) override;
-};
-
-class ElapseFormatter final : public Layout::FormatterItem {
-public:
-    explicit ElapseFormatter() = default;
-    void format(fmt::memory_buffer &buffer, const std::shared_ptr<LogEvent> &event) override;
-};
-
-class TabFormatter final : public Layout::FormatterItem {
-public:
-    explicit TabFormatter() = default;
-    void format(fmt::memory_buffer &buffer, const std::shared_ptr<LogEvent> &event) override;
+    std::string format_;
+    std::string prefix_format_;  // 亚秒占位符之前的部分，"{:...}" 形式
+    std::string suffix_format_;  // 亚秒占位符之后的部分，为空表示没有
+    int subsecond_digits_;       // 亚秒位数：0/3/6/9
+    uint64_t id_;                // 格式串编号，格式相同的实例共用 thread_local 缓存
 };
 
-// 字符串 param
-class StringFormatter final : public Layout::FormatterItem {
-public:
-    explicit StringFormatter(const std::string &str = "");
-    void format(fmt::memory_buffer &buffer, const std::shared_ptr<LogEvent> &event) override;
-
-private:
-    std::string str_;
-};
 }  // namespace log
 }  // namespace rein
 
@@ -1,10 +1,10 @@
 #ifndef REIN_LOG_LAYOUT_H_
 #define REIN_LOG_LAYOUT_H_
 
-#include <map>
+#include <cstdint>
 #include <memory>
+#include <string>
 #include <vector>
-#include <functional>
 
 #include "appender.h"
 #include "event.h"
@@ -13,6 +13,12 @@
 
 namespace rein {
 namespace log {
+/*
+  布局在构造时被编译成一段扁平的指令序列：
+  相邻的普通文本（含 %n、%T）合并为一段字面量，存放在同一个字符串池中；
+  格式化时按 switch 逐条解释，字面量、级别名、日志器名直接 memcpy，整数用 fmt::format_int，
+  只有带状态的时间戳（%d）仍通过 FormatterItem 虚函数完成。
+*/
 class Layout {
 public:
     class FormatterItem {
@@ -22,21 +28,47 @@ public:
         virtual void format(fmt::memory_buffer &buffer, const std::shared_ptr<LogEvent> &event) = 0;
     };
 
-    using FormatterFactory = std::function<std::shared_ptr<FormatterItem>()>;
-
     explicit Layout(const std::string &pattern = kDefaultLayout);
     ~Layout() = default;
 
+    // 直接追加到调用方提供的缓冲区，Appender 复用 thread_local 缓冲区时不产生分配
+    void format(fmt::memory_buffer &buffer, const std::shared_ptr<LogEvent> &event);
+
     std::string format(const std::shared_ptr<LogEvent> &event);
     std::string format(const std::shared_ptr<LogEvent> &event, Level level);
 
+    const std::string &pattern() const { return pattern_; }
+
 private:
+    enum class OpCode : uint8_t {
+        kLiteral,     ///< literals_[offset, offset + size)
+        kItem,        ///< items_[offset]->format()
+        kLoggerName,  ///< %c
+        kFileName,    ///< %f
+        kLine,        ///< %l
+        kMessage,     ///< %m
+        kThreadName,  ///< %N
+        kLevel,       ///< %p
+        kElapse,      ///< %r
+        kThreadId,    ///< %t
+        kKernelTid    ///< %t{tid}
+    };
+
+    struct Instruction {
+        OpCode op;
+        uint32_t offset;
+        uint32_t size;
+    };
+
     void parse_pattern();
+    void EmitLiteral(const std::string &text);
+    void Emit(char specifier, const std::string &param);
 
 private:
     std::string pattern_;
-    std::vector<std::shared_ptr<FormatterItem>> items_;
-    static const std::map<std::string, FormatterFactory> formatters_;
+    std::vector<Instruction> program_;
+    std::string literals_;                               // 所有字面量拼接在一起
+    std::vector<std::unique_ptr<FormatterItem>> items_;  // kItem 引用的有状态格式器
 };
 
 }  // namespace log
@@ -48,6 +48,9 @@ public:
 
     static std::string ToString(const LevelType& level);
 
+    // 级别名的静态字符串，不查表、不分配，供格式化热路径使用
+    static const char* Name(LevelType level);
+
     LevelType level() const;
 
 private:
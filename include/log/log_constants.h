@@ -1,12 +1,39 @@
 #ifndef REIN_LOG_CONSTANTS_H_
 #define REIN_LOG_CONSTANTS_H_
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
 #include <vector>
 
 constexpr const char* kDefaultLayout = "%d{:%Y-%m-%d %H:%M:%S.%f} [%p] [%c] %f:%l %m%n";
 constexpr const char* kRootLoggerName = "root";
 constexpr const char* kDefaultDateTimeParam = ":%Y-%m-%d %H:%M:%S";
+constexpr size_t kDefaultAsyncQueueSize = 8192;  // 异步队列默认容量
+constexpr size_t kDefaultEventPoolSize = 4096;   // LogEvent 池缓存的空闲块上限
+constexpr size_t kDefaultFileBufferSize = 64 * 1024;  // FileAppender 写缓冲区大小
+constexpr size_t kDefaultMmapChunkSize = 64 * 1024 * 1024;  // MmapFileAppender 每次映射的大小
+constexpr char kMmapPartialMarker = '#';  // 崩溃后未写完记录的占位字符
+constexpr size_t kDefaultRotateBytes = 100 * 1024 * 1024;  // RotatingFileAppender 默认滚动大小
+constexpr size_t kDefaultRotateFiles = 10;  // RotatingFileAppender 默认保留的归档数
+constexpr size_t kDefaultUringBufferSize = 256 * 1024;  // UringFileAppender 单个缓冲区大小
+constexpr size_t kDefaultUringBuffers = 4;  // UringFileAppender 缓冲区个数（同时在途的写请求上限）
+constexpr size_t kDefaultPreallocateSize = 16 * 1024 * 1024;  // DurableFileAppender 每次预分配的大小
+constexpr size_t kDefaultMergeFanIn = 256;  // MergeShards 单次同时打开的输入文件数上限
+constexpr size_t kDefaultNetBufferLimit = 4 * 1024 * 1024;  // NetAppender 对端不可用时最多缓冲的字节数
+constexpr size_t kNetSendBatch = 64;  // NetAppender 一次 sendmmsg 最多发送的数据报数
+constexpr long kNetReconnectMinMs = 100;    // NetAppender 重连退避的初始间隔
+constexpr long kNetReconnectMaxMs = 30000;  // NetAppender 重连退避的最大间隔
+constexpr long kNetConnectTimeoutMs = 1000;  // NetAppender 单次连接的超时
+constexpr long kNetFlushTimeoutMs = 1000;  // NetAppender::Flush 与析构时等待发送完成的上限
+constexpr size_t kDefaultShmRingSize = 16 * 1024 * 1024;  // ShmRingAppender 数据区默认容量
+constexpr size_t kDefaultFlightEvents = 4096;  // FlightRecorderAppender 默认保留的事件数
+constexpr size_t kDefaultFlightSlotSize = 256;  // FlightRecorderAppender 单条事件的槽位大小（含消息）
+constexpr size_t kDefaultBacktraceEvents = 256;  // BacktraceScope 默认缓冲的事件数
+constexpr size_t kDefaultDedupWindow = 8;  // DedupAppender 同时跟踪的不同消息数（1 表示只折叠连续重复）
+constexpr long kDefaultDedupSummaryMs = 1000;  // DedupAppender 定时写出重复汇总的间隔
+constexpr size_t kMaxSharedLayouts = 8;  // 单个 Logger 一次分发中最多共享渲染的布局数
+constexpr uint64_t kClockReanchorNs = 1000000000;  // kRealtime/kTsc 重新对齐墙上时间的间隔
 
 const std::vector<std::string> kAppenders = {"console", "file", "netw"};
 
@@ -6,22 +6,146 @@
 #define REIN_LOG_MACROS_H_
 
 #include "log_manager.h"
+#include "log_site.h"
 #include "logger.h"
 
 // 获取 root logger 的便捷宏
 #define REIN_ROOT_LOGGER() rein::log::LogManager::instance().root_logger()
 
+// 编译期日志级别，取值与 rein::log::LevelType 一致
+#define REIN_LEVEL_DEBUG 1
+#define REIN_LEVEL_INFO 2
+#define REIN_LEVEL_WARN 3
+#define REIN_LEVEL_ERROR 4
+#define REIN_LEVEL_FATAL 5
+#define REIN_LEVEL_OFF 6
+
+// 编译期阈值：低于该级别的日志语句展开为空语句，参数不会求值，格式串也不会进入二进制。
+// 通常由 CMake 选项 REIN_LOG_ACTIVE_LEVEL 设置，例如 -DREIN_LOG_ACTIVE_LEVEL=INFO
+#ifndef REIN_ACTIVE_LEVEL
+    #define REIN_ACTIVE_LEVEL REIN_LEVEL_DEBUG
+#endif
+
 // 通用日志宏
-#define REIN_LOG_DEBUG(logger, fmt, ...) \
-    logger->debug(__FILE__, __LINE__, __func__, fmt, ##__VA_ARGS__)
-#define REIN_LOG_INFO(logger, fmt, ...) \
-    logger->info(__FILE__, __LINE__, __func__, fmt, ##__VA_ARGS__)
-#define REIN_LOG_WARN(logger, fmt, ...) \
-    logger->warn(__FILE__, __LINE__, __func__, fmt, ##__VA_ARGS__)
-#define REIN_LOG_ERROR(logger, fmt, ...) \
-    logger->error(__FILE__, __LINE__, __func__, fmt, ##__VA_ARGS__)
-#define REIN_LOG_FATAL(logger, fmt, ...) \
-    logger->fatal(__FILE__, __LINE__, __func__, fmt, ##__VA_ARGS__)
+// fmt 必须是字符串字面量：经 REIN_FMT 包装后在编译期检查参数（C++17 起预编译格式串）。
+// 运行期拼出的格式串请直接调用 logger->info(__FILE__, __LINE__, __func__, str, ...)。
+// 级别判断在宏内完成：未开启的级别只有一次 relaxed 读取和一个分支，参数不会被求值。
+#define REIN_LOG_IMPL(logger, method, level, fmt, ...)                                       \
+    do {                                                                                     \
+        auto&& rein_logger_ = (logger);                                                      \
+        if (rein_logger_->enabled(rein::log::LevelType::level)) {                            \
+            rein_logger_->method(__FILE__, __LINE__, __func__, REIN_FMT(fmt), ##__VA_ARGS__); \
+        }                                                                                    \
+    } while (0)
+
+// 惰性日志：callable 只在级别开启时才被调用，其返回值作为消息内容
+#define REIN_LOG_LAZY_IMPL(logger, method, level, callable)                                 \
+    do {                                                                                    \
+        auto&& rein_logger_ = (logger);                                                     \
+        if (rein_logger_->enabled(rein::log::LevelType::level)) {                           \
+            rein_logger_->method(__FILE__, __LINE__, __func__, REIN_FMT("{}"), (callable)()); \
+        }                                                                                   \
+    } while (0)
+
+// 每个级别的宏都在下面的 #if 中二选一定义；REIN_LOG_IF_ACTIVE_<级别>(语句) 在级别低于编译期阈值时
+// 展开为空语句，语句本身（包括其中的静态变量与格式串）不进入编译
+#if REIN_ACTIVE_LEVEL <= REIN_LEVEL_DEBUG
+    #define REIN_LOG_DEBUG(logger, fmt, ...) \
+        REIN_LOG_IMPL(logger, debug, kDebug, fmt, ##__VA_ARGS__)
+    #define REIN_LOG_DEBUG_LAZY(logger, callable) \
+        REIN_LOG_LAZY_IMPL(logger, debug, kDebug, callable)
+    #define REIN_LOG_IF_ACTIVE_DEBUG(...) __VA_ARGS__
+#else
+    #define REIN_LOG_DEBUG(logger, fmt, ...) static_cast<void>(0)
+    #define REIN_LOG_DEBUG_LAZY(logger, callable) static_cast<void>(0)
+    #define REIN_LOG_IF_ACTIVE_DEBUG(...) static_cast<void>(0)
+#endif
+#if REIN_ACTIVE_LEVEL <= REIN_LEVEL_INFO
+    #define REIN_LOG_INFO(logger, fmt, ...) REIN_LOG_IMPL(logger, info, kInfo, fmt, ##__VA_ARGS__)
+    #define REIN_LOG_INFO_LAZY(logger, callable) REIN_LOG_LAZY_IMPL(logger, info, kInfo, callable)
+    #define REIN_LOG_IF_ACTIVE_INFO(...) __VA_ARGS__
+#else
+    #define REIN_LOG_INFO(logger, fmt, ...) static_cast<void>(0)
+    #define REIN_LOG_INFO_LAZY(logger, callable) static_cast<void>(0)
+    #define REIN_LOG_IF_ACTIVE_INFO(...) static_cast<void>(0)
+#endif
+#if REIN_ACTIVE_LEVEL <= REIN_LEVEL_WARN
+    #define REIN_LOG_WARN(logger, fmt, ...) REIN_LOG_IMPL(logger, warn, kWarn, fmt, ##__VA_ARGS__)
+    #define REIN_LOG_WARN_LAZY(logger, callable) REIN_LOG_LAZY_IMPL(logger, warn, kWarn, callable)
+    #define REIN_LOG_IF_ACTIVE_WARN(...) __VA_ARGS__
+#else
+    #define REIN_LOG_WARN(logger, fmt, ...) static_cast<void>(0)
+    #define REIN_LOG_WARN_LAZY(logger, callable) static_cast<void>(0)
+    #define REIN_LOG_IF_ACTIVE_WARN(...) static_cast<void>(0)
+#endif
+#if REIN_ACTIVE_LEVEL <= REIN_LEVEL_ERROR
+    #define REIN_LOG_ERROR(logger, fmt, ...) \
+        REIN_LOG_IMPL(logger, error, kError, fmt, ##__VA_ARGS__)
+    #define REIN_LOG_ERROR_LAZY(logger, callable) \
+        REIN_LOG_LAZY_IMPL(logger, error, kError, callable)
+    #define REIN_LOG_IF_ACTIVE_ERROR(...) __VA_ARGS__
+#else
+    #define REIN_LOG_ERROR(logger, fmt, ...) static_cast<void>(0)
+    #define REIN_LOG_ERROR_LAZY(logger, callable) static_cast<void>(0)
+    #define REIN_LOG_IF_ACTIVE_ERROR(...) static_cast<void>(0)
+#endif
+#if REIN_ACTIVE_LEVEL <= REIN_LEVEL_FATAL
+    #define REIN_LOG_FATAL(logger, fmt, ...) \
+        REIN_LOG_IMPL(logger, fatal, kFatal, fmt, ##__VA_ARGS__)
+    #define REIN_LOG_FATAL_LAZY(logger, callable) \
+        REIN_LOG_LAZY_IMPL(logger, fatal, kFatal, callable)
+    #define REIN_LOG_IF_ACTIVE_FATAL(...) __VA_ARGS__
+#else
+    #define REIN_LOG_FATAL(logger, fmt, ...) static_cast<void>(0)
+    #define REIN_LOG_FATAL_LAZY(logger, callable) static_cast<void>(0)
+    #define REIN_LOG_IF_ACTIVE_FATAL(...) static_cast<void>(0)
+#endif
+
+// 按调用点采样/限流的日志宏，level 取 DEBUG/INFO/WARN/ERROR/FATAL：
+//   REIN_LOG_EVERY_N(logger, INFO, 1000, "queue depth {}", depth);      // 第 1、1001、2001 ... 次
+//   REIN_LOG_FIRST_N(logger, WARN, 10, "bad packet from {}", peer);     // 只输出前 10 次
+//   REIN_LOG_EVERY_MS(logger, INFO, 500, "progress {}", done);          // 至少间隔 500ms
+//   REIN_LOG_RATE_LIMITED(logger, ERROR, 100, "write failed: {}", err);  // 令牌桶，每秒至多 100 条
+// 每个调用点有自己的静态状态（relaxed 原子量，见 log_site.h）。被跳过的调用不求值参数、不格式化；
+// 自上次输出以来跳过的次数附在下一条输出的消息末尾（" [suppressed N]"），因此格式串里只能用自动编号的 {}。
+// 低于编译期阈值的级别经 REIN_LOG_IF_ACTIVE_<级别> 整条去掉，连调用点的静态状态也不生成。
+#define REIN_LOG_METHOD_DEBUG debug
+#define REIN_LOG_METHOD_INFO info
+#define REIN_LOG_METHOD_WARN warn
+#define REIN_LOG_METHOD_ERROR error
+#define REIN_LOG_METHOD_FATAL fatal
+
+#define REIN_LOG_SITE_IMPL(logger, level, site, limit, fmt, ...) \
+    REIN_LOG_IF_ACTIVE_##level(REIN_LOG_SITE_BODY(logger, level, site, limit, fmt, ##__VA_ARGS__))
+
+#define REIN_LOG_SITE_BODY(logger, level, site, limit, fmt, ...)                                 \
+    do {                                                                                         \
+        auto&& rein_logger_ = (logger);                                                          \
+        if (rein_logger_->enabled(static_cast<rein::log::LevelType>(REIN_LEVEL_##level))) {      \
+            static site rein_site_;                                                              \
+            uint64_t rein_suppressed_ = 0;                                                       \
+            if (rein_site_.Admit((limit), rein_suppressed_)) {                                   \
+                if (rein_suppressed_ == 0) {                                                     \
+                    rein_logger_->REIN_LOG_METHOD_##level(__FILE__, __LINE__, __func__,          \
+                                                          REIN_FMT(fmt), ##__VA_ARGS__);         \
+                } else {                                                                         \
+                    rein_logger_->REIN_LOG_METHOD_##level(__FILE__, __LINE__, __func__,          \
+                                                          REIN_FMT(fmt " [suppressed {}]"),      \
+                                                          ##__VA_ARGS__, rein_suppressed_);      \
+                }                                                                                \
+            }                                                                                    \
+        }                                                                                        \
+    } while (0)
+
+#define REIN_LOG_EVERY_N(logger, level, n, fmt, ...) \
+    REIN_LOG_SITE_IMPL(logger, level, rein::log::detail::EveryNSite, n, fmt, ##__VA_ARGS__)
+#define REIN_LOG_FIRST_N(logger, level, n, fmt, ...) \
+    REIN_LOG_SITE_IMPL(logger, level, rein::log::detail::FirstNSite, n, fmt, ##__VA_ARGS__)
+#define REIN_LOG_EVERY_MS(logger, level, ms, fmt, ...) \
+    REIN_LOG_SITE_IMPL(logger, level, rein::log::detail::EveryMsSite, ms, fmt, ##__VA_ARGS__)
+#define REIN_LOG_RATE_LIMITED(logger, level, per_second, fmt, ...)                           \
+    REIN_LOG_SITE_IMPL(logger, level, rein::log::detail::RateLimitSite, per_second, fmt, \
+                       ##__VA_ARGS__)
 
 // Root Logger 便捷宏
 #define REIN_LOG_D(fmt, ...) REIN_LOG_DEBUG(REIN_ROOT_LOGGER(), fmt, ##__VA_ARGS__)
@@ -106,6 +230,17 @@
     rein::log::LogManager::instance().AddAppender(logger_name, rein::log::AppenderType::FILE, \
                                                   file_path)
 
+/**
+ * @brief 开启全局异步输出。
+ * @param ... capacity (可选, 队列容量), policy (可选, rein::log::OverflowPolicy)。
+ */
+#define REIN_ENABLE_ASYNC(...) rein::log::LogManager::instance().EnableAsync(__VA_ARGS__)
+
+/**
+ * @brief 等待所有异步日志输出完毕。
+ */
+#define REIN_FLUSH() rein::log::LogManager::instance().Flush()
+
 /**
  * @brief 获取一个已存在的 Logger 实例的 shared_ptr。
  * @param logger_name Logger 的名称 (字符串)。
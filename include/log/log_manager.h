@@ -5,10 +5,13 @@
 #include <map>
 #include <mutex>
 #include <string>
+#include <vector>
 
 #include <fmt/core.h>
 
 #include "appender.h"
+#include "async_worker.h"
+#include "clock.h"
 #include "log_constants.h"
 
 namespace rein {
@@ -55,14 +58,48 @@ public:
                    const std::string& appender_out = kConsole,
                    const std::string& layout = kDefaultLayout);
 
+    /**
+     * @brief 开启全局异步模式，所有 logger（包括之后添加的）共用一个后台线程。
+     * @param capacity 队列容量（向上取整为 2 的幂）。
+     * @param policy 队列满时的处理策略。
+     */
+    void EnableAsync(size_t capacity = kDefaultAsyncQueueSize,
+                     OverflowPolicy policy = OverflowPolicy::kBlock);
+
+    /**
+     * @brief 只为指定 logger 开启异步模式，使用独立的后台线程。
+     */
+    void EnableAsync(const std::string& logger_name,
+                     size_t capacity = kDefaultAsyncQueueSize,
+                     OverflowPolicy policy = OverflowPolicy::kBlock);
+
+    // 所有 logger 恢复同步输出，并停止后台线程
+    void DisableAsync();
+
+    // 等待所有异步队列清空
+    void Flush();
+
+    // 输出所有未完成的异步日志并停止后台线程，析构时自动调用
+    void Shutdown();
+
+    /**
+     * @brief 选择 LogEvent 时间戳的时钟来源，对之后产生的事件生效。
+     * kTsc 需要不变 TSC，不满足时退回 kRealtime，可通过 clock() 查询实际生效的类型。
+     */
+    void SetClock(ClockType type);
+    ClockType clock() const;
+
 private:
     LogManager();  // 私有构造
+    ~LogManager();
 
     LogManager(const LogManager&) = delete;
     LogManager& operator=(const LogManager&) = delete;
 
     std::map<std::string, std::shared_ptr<Logger>> loggers_;
     std::shared_ptr<Logger> root_logger_;
+    std::shared_ptr<AsyncWorker> async_;               // 全局异步模式的 worker
+    std::vector<std::shared_ptr<AsyncWorker>> workers_;  // 创建过的全部 worker
     std::mutex mutex_;
 };
 }  // namespace log
@@ -0,0 +1,123 @@
+#ifndef REIN_LOG_LOG_SITE_H_
+#define REIN_LOG_LOG_SITE_H_
+
+#include <time.h>
+
+#include <atomic>
+#include <cstdint>
+
+#include "clock.h"
+
+namespace rein {
+namespace log {
+namespace detail {
+
+/*
+  采样/限流宏在每个调用点的静态状态（见 log_macros.h 中的 REIN_LOG_EVERY_N 等）。
+  构造函数都是 constexpr，函数内的 static 对象在编译期初始化，没有线程安全初始化的守卫开销；
+  状态只用 relaxed 原子操作更新。
+  Admit() 返回 true 表示这一次输出，suppressed 为自上次输出以来被跳过的次数。
+*/
+
+// 每 n 次输出一次：第 1、n+1、2n+1 ... 次
+class EveryNSite {
+public:
+    constexpr EveryNSite() : count_(0) {}
+
+    bool Admit(uint64_t n, uint64_t& suppressed) {
+        const uint64_t count = count_.fetch_add(1, std::memory_order_relaxed);
+        if (n <= 1) {
+            return true;
+        }
+        if (count % n != 0) {
+            return false;
+        }
+        suppressed = count == 0 ? 0 : n - 1;
+        return true;
+    }
+
+private:
+    std::atomic<uint64_t> count_;
+};
+
+// 只输出前 n 次；之后不再有输出的机会，跳过的次数不会被报告
+class FirstNSite {
+public:
+    constexpr FirstNSite() : count_(0) {}
+
+    bool Admit(uint64_t n, uint64_t& /*suppressed*/) {
+        // 额度用完后只读不写，热循环里不再争抢缓存行
+        if (count_.load(std::memory_order_relaxed) >= n) {
+            return false;
+        }
+        return count_.fetch_add(1, std::memory_order_relaxed) < n;
+    }
+
+private:
+    std::atomic<uint64_t> count_;
+};
+
+// 两次输出至少间隔 interval_ms 毫秒。用粗粒度单调时钟（精度为一个时钟节拍，通常 1~4ms），读取只需几纳秒
+class EveryMsSite {
+public:
+    constexpr EveryMsSite() : next_ns_(0), skipped_(0) {}
+
+    bool Admit(uint64_t interval_ms, uint64_t& suppressed) {
+        const uint64_t now = Clock::Read(CLOCK_MONOTONIC_COARSE);
+        uint64_t next = next_ns_.load(std::memory_order_relaxed);
+        if (now < next ||
+            !next_ns_.compare_exchange_strong(next, now + interval_ms * 1000000,
+                                              std::memory_order_relaxed)) {
+            skipped_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        suppressed = skipped_.exchange(0, std::memory_order_relaxed);
+        return true;
+    }
+
+private:
+    std::atomic<uint64_t> next_ns_;  // 下一次允许输出的时刻
+    std::atomic<uint64_t> skipped_;
+};
+
+/*
+  令牌桶：平均每秒 per_second 条，允许一次突发 per_second 条（桶容量为一秒的额度）。
+  按 GCRA 实现，整个桶只有一个原子量：tat_ 是“理论到达时间”，每放行一条向后推一个间隔，
+  超出当前时刻一秒以上说明桶已空。
+*/
+class RateLimitSite {
+public:
+    constexpr RateLimitSite() : tat_ns_(0), skipped_(0) {}
+
+    bool Admit(uint64_t per_second, uint64_t& suppressed) {
+        if (per_second == 0) {
+            return false;
+        }
+        const uint64_t interval = 1000000000 / per_second;
+        const uint64_t burst = interval * per_second;
+        const uint64_t now = Clock::Read(CLOCK_MONOTONIC_COARSE);
+        uint64_t tat = tat_ns_.load(std::memory_order_relaxed);
+        for (;;) {
+            const uint64_t next = (tat > now ? tat : now) + interval;
+            if (next - now > burst) {
+                skipped_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            if (tat_ns_.compare_exchange_weak(tat, next, std::memory_order_relaxed)) {
+                break;
+            }
+        }
+        suppressed = skipped_.exchange(0, std::memory_order_relaxed);
+        return true;
+    }
+
+private:
+    std::atomic<uint64_t> tat_ns_;
+    std::atomic<uint64_t> skipped_;
+};
+
+}  // namespace detail
+}  // namespace log
+}  // namespace rein
+
+#endif  // REIN_LOG_LOG_SITE_H_
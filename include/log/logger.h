@@ -1,43 +1,52 @@
 #ifndef REIN_LOG_LOGGER_H_
 #define REIN_LOG_LOGGER_H_
 
+#include <atomic>
 #include <memory>
 #include <string>
+#include <type_traits>
 #include <vector>
 #include "appender.h"
+#include "arg_record.h"
+#include "backtrace.h"
 #include "event.h"
+#include "format_string.h"
 namespace rein {
 namespace log {
 
 class LogEvent;
+class Layout;
 class Appender;
+class AsyncWorker;
 class LogManager;
 class Logger : public std::enable_shared_from_this<Logger> {
     friend class LogManager;
+    friend class AsyncWorker;
+    friend class BacktraceScope;
 
 public:
     Logger(const Logger&) = delete;
     Logger& operator=(const Logger&) = delete;
 
-    template <typename... Args>
-    void debug(
-        const char* file, uint32_t line, const char* func, const std::string& fmt, Args&&... args);
+    /**
+     * 格式串 fmt 支持：
+     *  - REIN_FMT("...")（REIN_LOG_* 宏默认使用）：编译期检查，C++17 起预编译，无运行期解析；
+     *  - std::string / const char* 等运行期字符串：运行期解析，错误以异常形式抛出。
+     */
+    template <typename S, typename... Args>
+    void debug(const char* file, uint32_t line, const char* func, const S& fmt, Args&&... args);
 
-    template <typename... Args>
-    void info(
-        const char* file, uint32_t line, const char* func, const std::string& fmt, Args&&... args);
+    template <typename S, typename... Args>
+    void info(const char* file, uint32_t line, const char* func, const S& fmt, Args&&... args);
 
-    template <typename... Args>
-    void warn(
-        const char* file, uint32_t line, const char* func, const std::string& fmt, Args&&... args);
+    template <typename S, typename... Args>
+    void warn(const char* file, uint32_t line, const char* func, const S& fmt, Args&&... args);
 
-    template <typename... Args>
-    void error(
-        const char* file, uint32_t line, const char* func, const std::string& fmt, Args&&... args);
+    template <typename S, typename... Args>
+    void error(const char* file, uint32_t line, const char* func, const S& fmt, Args&&... args);
 
-    template <typename... Args>
-    void fatal(
-        const char* file, uint32_t line, const char* func, const std::string& fmt, Args&&... args);
+    template <typename S, typename... Args>
+    void fatal(const char* file, uint32_t line, const char* func, const S& fmt, Args&&... args);
 
     void AddAppender(std::shared_ptr<Appender> appender);
     void AddAppender(AppenderType type, const std::string& out = kConsole);
@@ -52,68 +61,191 @@ public:
 
     void SetLevel(Level level);
 
+    // 无锁读取当前级别，日志宏在求值参数之前先调用它。
+    // 当前线程处于 BacktraceScope 中时，低于其阈值的级别也算开启（事件进入回溯缓冲区）；
+    // 只有存在回溯作用域时才读取线程局部的作用域状态
+    bool enabled(LevelType level) const {
+        return level >= level_.load(std::memory_order_relaxed) ||
+               (detail::BacktraceScopes().load(std::memory_order_relaxed) != 0 &&
+                level < detail::Backtrace().threshold);
+    }
+
+    /**
+     * @brief 设置异步输出的后台线程，传入 nullptr 恢复同步输出。
+     * 同一个 AsyncWorker 可以被多个 Logger 共享。
+     */
+    void SetAsync(std::shared_ptr<AsyncWorker> worker);
+    std::shared_ptr<AsyncWorker> async() const;
+
+    // 异步模式下等待已提交的日志全部输出
+    void Flush();
+
+    /**
+     * @brief 开启/关闭延迟格式化。
+     * 开启后，编译期格式串（REIN_FMT）且参数均为基础类型/字符串的调用只把参数拷贝进 ArgRecord，
+     * fmt 渲染推迟到 Appender 输出时进行（配合异步模式即在后台线程完成）。
+     */
+    void SetDeferred(bool deferred);
+    bool deferred() const;
+
     Level level() const;
     const std::string& name() const;
 
 private:
+    using AppenderList = std::vector<std::shared_ptr<Appender>>;
+
     // 私有构造函数，强制通过 LogManager 创建
     explicit Logger(const std::string& name, Level level = Level(LevelType::kDebug));
 
-    void log(
-        Level level, const char* file, uint32_t line, const char* func, const std::string& message);
+    // 从事件池中取出一个事件，消息由调用方随后写入
+    std::shared_ptr<LogEvent> MakeEvent(Level level,
+                                        const char* file,
+                                        uint32_t line,
+                                        const char* func);
+
+    // 编译期格式串且参数都可捕获：按模式选择延迟或即时格式化
+    template <typename S, typename... Args>
+    void Submit(std::true_type,
+                Level level,
+                const char* file,
+                uint32_t line,
+                const char* func,
+                const S& fmt,
+                const Args&... args);
+
+    // 运行期格式串或含有无法捕获的参数类型：只能即时格式化
+    template <typename S, typename... Args>
+    void Submit(std::false_type,
+                Level level,
+                const char* file,
+                uint32_t line,
+                const char* func,
+                const S& fmt,
+                Args&&... args);
+
+    void Post(std::shared_ptr<LogEvent> event);
+
+    // 将事件分发给所有 Appender（同步模式在调用线程，异步模式在后台线程）
+    // 布局相同的 Appender 共享同一次渲染结果
+    void CallAppenders(const std::shared_ptr<LogEvent>& event);
+
+    static bool SameLayout(const Layout* lhs, const Layout* rhs);
 
 private:
     std::string name_;
     mutable std::mutex mutex_;
-    Level level_;
-    std::vector<std::shared_ptr<Appender>> appenders_;
+    std::atomic<LevelType> level_;  // 热路径只做一次 relaxed 读取
+    // 写时复制：修改时整体替换，CallAppenders 取得快照后不持锁分发，
+    // 避免一个慢 Appender（如等待落盘）把同一 Logger 的其他线程串行化
+    std::shared_ptr<const AppenderList> appenders_;
+    std::atomic<bool> deferred_;
+
+    // 热路径上只读原子裸指针，不加锁；所有权由 async_owner_ 持有
+    std::atomic<AsyncWorker*> async_;
+    std::shared_ptr<AsyncWorker> async_owner_;
+    // 被替换下来的 worker 可能仍有线程在使用，保留到 Logger 析构
+    std::vector<std::shared_ptr<AsyncWorker>> retired_async_;
 };
 
-template <typename... Args>
+template <typename S, typename... Args>
 void Logger::debug(
-    const char* file, uint32_t line, const char* func, const std::string& fmt, Args&&... args) {
-    if (level_.cmp(LevelType::kDebug)) {
-        log(Level(LevelType::kDebug), file, line, func,
-            fmt::format(fmt, std::forward<Args>(args)...));
+    const char* file, uint32_t line, const char* func, const S& fmt, Args&&... args) {
+    if (enabled(LevelType::kDebug)) {
+        Submit(detail::CanDefer<S, typename std::decay<Args>::type...>(), Level(LevelType::kDebug),
+               file, line, func, fmt, std::forward<Args>(args)...);
     }
 }
 
-template <typename... Args>
+template <typename S, typename... Args>
 void Logger::info(
-    const char* file, uint32_t line, const char* func, const std::string& fmt, Args&&... args) {
-    if (level_.cmp(LevelType::kInfo)) {
-        log(Level(LevelType::kInfo), file, line, func,
-            fmt::format(fmt, std::forward<Args>(args)...));
+    const char* file, uint32_t line, const char* func, const S& fmt, Args&&... args) {
+    if (enabled(LevelType::kInfo)) {
+        Submit(detail::CanDefer<S, typename std::decay<Args>::type...>(), Level(LevelType::kInfo),
+               file, line, func, fmt, std::forward<Args>(args)...);
     }
 }
 
-template <typename... Args>
+template <typename S, typename... Args>
 void Logger::warn(
-    const char* file, uint32_t line, const char* func, const std::string& fmt, Args&&... args) {
-    if (level_.cmp(LevelType::kWarn)) {
-        log(Level(LevelType::kWarn), file, line, func,
-            fmt::format(fmt, std::forward<Args>(args)...));
+    const char* file, uint32_t line, const char* func, const S& fmt, Args&&... args) {
+    if (enabled(LevelType::kWarn)) {
+        Submit(detail::CanDefer<S, typename std::decay<Args>::type...>(), Level(LevelType::kWarn),
+               file, line, func, fmt, std::forward<Args>(args)...);
     }
 }
 
-template <typename... Args>
+template <typename S, typename... Args>
 void Logger::error(
-    const char* file, uint32_t line, const char* func, const std::string& fmt, Args&&... args) {
-    if (level_.cmp(LevelType::kError)) {
-        log(Level(LevelType::kError), file, line, func,
-            fmt::format(fmt, std::forward<Args>(args)...));
+    const char* file, uint32_t line, const char* func, const S& fmt, Args&&... args) {
+    if (enabled(LevelType::kError)) {
+        Submit(detail::CanDefer<S, typename std::decay<Args>::type...>(), Level(LevelType::kError),
+               file, line, func, fmt, std::forward<Args>(args)...);
     }
 }
 
-template <typename... Args>
+template <typename S, typename... Args>
 void Logger::fatal(
-    const char* file, uint32_t line, const char* func, const std::string& fmt, Args&&... args) {
-    if (level_.cmp(LevelType::kFatal)) {
-        log(Level(LevelType::kFatal), file, line, func,
-            fmt::format(fmt, std::forward<Args>(args)...));
+    const char* file, uint32_t line, const char* func, const S& fmt, Args&&... args) {
+    if (enabled(LevelType::kFatal)) {
+        Submit(detail::CanDefer<S, typename std::decay<Args>::type...>(), Level(LevelType::kFatal),
+               file, line, func, fmt, std::forward<Args>(args)...);
     }
 }
 
+template <typename S, typename... Args>
+void Logger::Submit(std::true_type,
+                    Level level,
+                    const char* file,
+                    uint32_t line,
+                    const char* func,
+                    const S& fmt,
+                    const Args&... args) {
+    if (detail::BacktraceScopes().load(std::memory_order_relaxed) != 0) {
+        detail::BacktraceState& backtrace = detail::Backtrace();
+        if (level.level() < backtrace.threshold) {
+            backtrace.scope->Capture(this, level, file, line, func, detail::ToStringView(fmt),
+                                     args...);
+            return;
+        }
+        if (backtrace.scope && level.level() >= backtrace.trigger) {
+            backtrace.scope->Flush();
+        }
+    }
+
+    auto event = MakeEvent(level, file, line, func);
+    if (deferred_.load(std::memory_order_relaxed)) {
+        event->Capture(detail::ToStringView(fmt), args...);
+    } else {
+        event->Format(fmt, args...);
+    }
+    Post(std::move(event));
+}
+
+template <typename S, typename... Args>
+void Logger::Submit(std::false_type,
+                    Level level,
+                    const char* file,
+                    uint32_t line,
+                    const char* func,
+                    const S& fmt,
+                    Args&&... args) {
+    if (detail::BacktraceScopes().load(std::memory_order_relaxed) != 0) {
+        detail::BacktraceState& backtrace = detail::Backtrace();
+        if (level.level() < backtrace.threshold) {
+            backtrace.scope->CaptureFormatted(this, level, file, line, func, fmt,
+                                              std::forward<Args>(args)...);
+            return;
+        }
+        if (backtrace.scope && level.level() >= backtrace.trigger) {
+            backtrace.scope->Flush();
+        }
+    }
+
+    auto event = MakeEvent(level, file, line, func);
+    event->Format(fmt, std::forward<Args>(args)...);
+    Post(std::move(event));
+}
+
 }  // namespace log
 }  // namespace rein
 
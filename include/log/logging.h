@@ -6,9 +6,25 @@
 #include "log/logger.h"
 #include "log/level.h"
 #include "log/appender.h"
+#include "log/mmap_appender.h"
+#include "log/rotating_appender.h"
+#include "log/uring_appender.h"
+#include "log/durable_appender.h"
+#include "log/binary_appender.h"
+#include "log/binary_reader.h"
+#include "log/shard_appender.h"
+#include "log/net_appender.h"
+#include "log/shm_appender.h"
+#include "log/shm_reader.h"
+#include "log/flight_appender.h"
+#include "log/dedup_appender.h"
+#include "log/backtrace.h"
+#include "log/async_worker.h"
+#include "log/clock.h"
 // layout 和 event 通常是间接使用，但为了配置方便，也可以暴露
 #include "log/layout.h"
 #include "log/event.h"
+#include "log/thread_info.h"
 #include "log/log_constants.h"
 
 // 包含所有用户需要使用的宏
@@ -0,0 +1,80 @@
+#ifndef REIN_LOG_MMAP_APPENDER_H_
+#define REIN_LOG_MMAP_APPENDER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "appender.h"
+#include "log_constants.h"
+
+namespace rein {
+namespace log {
+
+/*
+  基于内存映射的文件输出地，写入路径不加锁。
+  文件按 chunk_size 对齐分块预分配并映射，写线程用 fetch_add 在写偏移上预留空间，
+  再把渲染好的日志 memcpy 进映射区；某块被写满（所有预留都已完成）时解除映射。
+  同时映射的块数固定为 kSlots，预留跑到了仍被未写完的旧块占着的槽位时不等待旧块，
+  这一段改用 pwrite 写入（与映射区共享页缓存），写线程被挂起也不会拖住其他线程。
+  每条记录先写除首字节以外的内容，最后写首字节：进程崩溃后，未完成的记录以 NUL 开头。
+  正常关闭时把文件截断到实际长度；重新打开崩溃留下的文件时，去掉末尾未使用的预分配空间，
+  并把未写完记录留下的 NUL 替换为 kMmapPartialMarker，文件始终可以按文本读取。
+*/
+class MmapFileAppender final : public Appender {
+public:
+    explicit MmapFileAppender(const std::string& name,
+                              size_t chunk_size = kDefaultMmapChunkSize);
+    ~MmapFileAppender() override;
+
+    void Log(const std::shared_ptr<LogEvent> event, Level level) override;
+    void Write(const std::shared_ptr<LogEvent>& event, fmt::string_view formatted) override;
+    bool SupportsPreformatted() const override { return true; }
+
+    const std::string& file() const { return file_name_; }
+    size_t chunk_size() const { return chunk_size_; }
+
+private:
+    // 同时处于映射状态的块数；一个块只有在全部写完后才会让出槽位
+    static constexpr size_t kSlots = 4;
+
+    struct Chunk {
+        std::atomic<uint64_t> index{~0ull};  // 映射的是文件的第几块
+        std::atomic<char*> addr{nullptr};
+        std::atomic<uint64_t> committed{0};  // 已写完的字节数，等于块大小时解除映射
+    };
+
+    void Append(const char* data, size_t size);
+    // 返回第 index 块的映射地址；槽位仍被别的块占用时返回 nullptr，由调用方改用 WriteAt
+    char* Acquire(uint64_t index);
+    // 记录第 index 块写完了 bytes 字节，mapped 表示是否经由映射区写入；写满的块解除映射
+    void Commit(uint64_t index, size_t bytes, bool mapped);
+    void WriteAt(const char* data, size_t size, uint64_t offset);
+    // 第 index 块中打开文件前就已存在的字节数
+    uint64_t InitialCommitted(uint64_t index) const;
+    // 调用方持有 map_mutex_
+    void Unmap(Chunk& chunk);
+
+    void Open();
+    void Recover(uint64_t size);
+    void Close();
+
+private:
+    std::string file_name_;
+    int fd_ = -1;
+    const size_t chunk_size_;
+    uint64_t start_ = 0;             // 打开时文件的长度，之前的内容不会被改写
+    std::atomic<uint64_t> offset_;   // 下一条记录的文件偏移
+    Chunk slots_[kSlots];
+    std::mutex map_mutex_;           // 只在映射新块与 pwrite 回退时使用
+    // 尚未映射的块中已用 pwrite 写完的字节数，受 map_mutex_ 保护
+    std::unordered_map<uint64_t, uint64_t> early_commits_;
+};
+
+}  // namespace log
+}  // namespace rein
+
+#endif  // REIN_LOG_MMAP_APPENDER_H_
@@ -0,0 +1,116 @@
+#ifndef REIN_LOG_NET_APPENDER_H_
+#define REIN_LOG_NET_APPENDER_H_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "appender.h"
+#include "log_constants.h"
+
+namespace rein {
+namespace log {
+
+enum class NetProtocol : uint8_t {
+    kTcp,
+    kUdp  ///< 每条记录一个数据报
+};
+
+// 记录在字节流中的分帧方式
+enum class NetFraming : uint8_t {
+    kNewline,        ///< 依赖布局以 %n 结尾（默认布局满足）
+    kLengthPrefixed  ///< 每条记录前加 4 字节大端长度
+};
+
+/*
+  网络输出地：把日志按记录发送到 [tcp://|udp://]host:port（默认 TCP，IPv6 地址写作 [::1]:port）。
+  写日志的线程只把渲染好的记录追加到待发送缓冲区；连接、发送与重连都在本 Appender 自己的后台线程中进行，
+  套接字是非阻塞的，写日志的线程不会因为网络而阻塞。
+  后台线程每次取走整个待发送缓冲区：TCP 一次 sendmsg 发出整批，UDP 用 sendmmsg 每次最多发 kNetSendBatch 个数据报。
+  连接失败或断开后按指数退避重连（kNetReconnectMinMs 起，最长 kNetReconnectMaxMs），期间继续缓冲，
+  待发送数据超过 buffer_limit 字节时丢弃新的记录并计入 dropped()。
+  TCP 断开时发送了一半的记录在重连后从头重发，对端可能看到一条不完整的记录后跟完整的同一条。
+*/
+class NetAppender final : public Appender {
+public:
+    // 地址格式错误时抛出 std::invalid_argument；主机名在后台线程中解析，每次重连重新解析
+    explicit NetAppender(const std::string& address,
+                         NetFraming framing = NetFraming::kNewline,
+                         size_t buffer_limit = kDefaultNetBufferLimit);
+    // 最多等待 kNetFlushTimeoutMs 发出剩余的记录
+    ~NetAppender() override;
+
+    void Log(const std::shared_ptr<LogEvent> event, Level level) override;
+    void Write(const std::shared_ptr<LogEvent>& event, fmt::string_view formatted) override;
+    bool SupportsPreformatted() const override { return true; }
+
+    // 等待此前的记录全部交给内核，最多 kNetFlushTimeoutMs；对端不可用时立即返回
+    void Flush() override;
+
+    NetProtocol protocol() const { return protocol_; }
+    NetFraming framing() const { return framing_; }
+    bool connected() const { return connected_.load(std::memory_order_relaxed); }
+    // 因缓冲区已满或数据报过大而丢弃的记录数
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    // 补上长度前缀、检查缓冲区上限并唤醒发送线程；调用方持有 mutex_
+    void CommitLocked(size_t start);
+
+    void Run();
+    bool Connect();
+    void Disconnect();
+    bool PeerClosed() const;
+    bool WaitWritable() const;
+    bool SendStream();
+    bool SendDatagrams();
+    // 发送失败后回到第一条未发完的记录的开头
+    void Rewind();
+
+private:
+    NetProtocol protocol_ = NetProtocol::kTcp;
+    NetFraming framing_;
+    std::string host_;
+    std::string port_;
+    size_t buffer_limit_;
+
+    // 一批首尾相接的记录
+    struct Batch {
+        fmt::memory_buffer data;
+        std::vector<size_t> ends;  // 每条记录在 data 中的结束位置
+    };
+    Batch batches_[2];
+
+    // 以下受 mutex_ 保护
+    Batch* pending_ = &batches_[0];    // 写日志的线程追加到这里，发送线程整批换走
+    uint64_t appended_ = 0;            // 累计进入 pending_ 的字节数
+    uint64_t sent_ = 0;                // 累计交给内核（或因断开放弃）的字节数
+    bool idle_ = false;                // 发送线程在等待新记录
+    bool down_ = false;                // 最近一次连接或发送失败，尚未恢复
+    bool overflow_ = false;            // 本次缓冲区满已经提示过
+    std::condition_variable cv_;       // 唤醒发送线程
+    std::condition_variable sent_cv_;  // 唤醒 Flush
+
+    std::atomic<bool> stop_{false};
+    std::chrono::steady_clock::time_point stop_deadline_;  // stop_ 置位前写入
+    std::atomic<bool> connected_{false};
+    std::atomic<uint64_t> dropped_{0};
+
+    // 以下只由发送线程访问
+    int fd_ = -1;
+    Batch* sending_ = &batches_[1];     // 正在发送的一批，与 pending_ 交换时持有 mutex_
+    size_t record_ = 0;                 // 下一条要发送的记录下标
+    size_t offset_ = 0;                 // 已发送到的字节位置（TCP 可能停在记录中间）
+
+    std::thread sender_;
+};
+
+}  // namespace log
+}  // namespace rein
+
+#endif  // REIN_LOG_NET_APPENDER_H_
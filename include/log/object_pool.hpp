@@ -0,0 +1,92 @@
+#ifndef REIN_LOG_OBJECT_POOL_H_
+#define REIN_LOG_OBJECT_POOL_H_
+
+#include <cstddef>
+#include <new>
+
+#include "bounded_queue.hpp"
+#include "log_constants.h"
+
+namespace rein {
+namespace log {
+
+/*
+  定长内存块池。
+  空闲块放在无锁的 BoundedQueue 中：异步模式下事件在业务线程分配、在后台线程释放，
+  块可以跨线程归还，不会像纯 thread_local 空闲链表那样单向流向后台线程。
+  池空时退回 operator new，池满时直接 operator delete，稳态下不再触碰系统分配器。
+*/
+template <size_t Size>
+class BlockPool {
+public:
+    // 进程退出时仍可能有事件在释放，池对象刻意不析构
+    static BlockPool& Instance() {
+        static BlockPool* pool = new BlockPool(kDefaultEventPoolSize);
+        return *pool;
+    }
+
+    void* Allocate() {
+        void* block = nullptr;
+        if (free_.TryPop(block)) {
+            return block;
+        }
+        return ::operator new(Size);
+    }
+
+    void Deallocate(void* block) {
+        if (!free_.TryPush(block)) {
+            ::operator delete(block);
+        }
+    }
+
+private:
+    explicit BlockPool(size_t capacity)
+        : free_(capacity) {}
+
+    BoundedQueue<void*> free_;
+};
+
+/*
+  供 std::allocate_shared 使用的分配器，对象与 shared_ptr 控制块一起从 BlockPool 中分配。
+  rebind 后的每种类型按自身大小各有一个池。
+*/
+template <typename T>
+class PoolAllocator {
+public:
+    using value_type = T;
+
+    PoolAllocator() = default;
+
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U>&) {}
+
+    T* allocate(size_t n) {
+        if (n != 1) {
+            return static_cast<T*>(::operator new(n * sizeof(T)));
+        }
+        return static_cast<T*>(BlockPool<sizeof(T)>::Instance().Allocate());
+    }
+
+    void deallocate(T* p, size_t n) {
+        if (n != 1) {
+            ::operator delete(p);
+            return;
+        }
+        BlockPool<sizeof(T)>::Instance().Deallocate(p);
+    }
+
+    template <typename U>
+    bool operator==(const PoolAllocator<U>&) const {
+        return true;
+    }
+
+    template <typename U>
+    bool operator!=(const PoolAllocator<U>&) const {
+        return false;
+    }
+};
+
+}  // namespace log
+}  // namespace rein
+
+#endif  // REIN_LOG_OBJECT_POOL_H_
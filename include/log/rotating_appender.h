@@ -0,0 +1,102 @@
+#ifndef REIN_LOG_ROTATING_APPENDER_H_
+#define REIN_LOG_ROTATING_APPENDER_H_
+
+#include <condition_variable>
+#include <cstdint>
+#include <ctime>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "appender.h"
+#include "log_constants.h"
+
+namespace rein {
+namespace log {
+
+// 按时间滚动的周期，边界取本地时间的整点 / 零点
+enum class RotateInterval : uint8_t {
+    kNone,
+    kHourly,
+    kDaily
+};
+
+// 归档文件的压缩方式；需要构建时找到对应的库（zlib / libzstd）
+enum class Compression : uint8_t {
+    kNone,
+    kGzip,  ///< 追加 .gz 后缀
+    kZstd   ///< 追加 .zst 后缀
+};
+
+struct RotationPolicy {
+    uint64_t max_bytes = kDefaultRotateBytes;  // 单个文件的大小上限，0 表示不按大小滚动
+    RotateInterval interval = RotateInterval::kNone;
+    Compression compression = Compression::kNone;
+    size_t max_files = kDefaultRotateFiles;  // 最多保留的归档数，0 表示不限
+    uint64_t max_total_bytes = 0;            // 归档总大小上限，0 表示不限
+};
+
+/*
+  滚动文件输出地。
+  写入前检查当前文件大小与时间边界，需要滚动时：写出缓冲、把文件 rename 为
+  "<文件名>.<YYYYmmdd-HHMMSS>"、打开新文件并替换 fd，整个过程只有几次系统调用。
+  归档文件的压缩与按数量 / 总大小的清理交给本 Appender 自己的后台线程，写日志的线程不会等待。
+  重新打开时会补做上次退出前没来得及完成的压缩。
+*/
+class RotatingFileAppender final : public FileAppender {
+public:
+    explicit RotatingFileAppender(const std::string& name,
+                                  const RotationPolicy& policy = RotationPolicy());
+    ~RotatingFileAppender() override;
+
+    void Log(const std::shared_ptr<LogEvent> event, Level level) override;
+    void Write(const std::shared_ptr<LogEvent>& event, fmt::string_view formatted) override;
+
+    // 压缩方式在当前构建中不可用时抛出 std::invalid_argument
+    void SetPolicy(const RotationPolicy& policy);
+    RotationPolicy policy() const;
+
+    // 立即滚动当前文件
+    void Rotate();
+
+    // 阻塞直到已经提交的压缩与清理全部完成
+    void WaitForArchive();
+
+private:
+    void AppendRecordLocked(const std::shared_ptr<LogEvent>& event, fmt::string_view formatted);
+    void RollLocked(std::time_t now);
+    void ScheduleLocked(std::time_t from);
+    std::string ArchiveName(std::time_t now);
+
+    void RunArchiver();
+    void Recover();
+    void Compress(const std::string& path, Compression compression);
+    void Prune();
+
+private:
+    struct Task {
+        std::string path;  // 空路径表示只做清理
+        Compression compression;
+    };
+
+    RotationPolicy policy_;        // 受 mutex_ 保护
+    uint64_t written_ = 0;         // 当前文件的长度（含缓冲中未写出的部分）
+    std::time_t next_roll_ = 0;    // 下一个时间边界，0 表示不按时间滚动
+    std::time_t last_roll_ = 0;    // 上次滚动的时间
+    unsigned long seq_ = 0;        // 同一秒内的滚动序号
+    fmt::memory_buffer record_;    // Log() 渲染单条日志用，受 mutex_ 保护
+
+    std::mutex archive_mutex_;
+    std::condition_variable archive_cv_;
+    std::deque<Task> tasks_;       // 受 archive_mutex_ 保护
+    bool busy_ = false;            // 后台线程正在处理任务
+    bool stop_ = false;
+    std::thread archiver_;
+};
+
+}  // namespace log
+}  // namespace rein
+
+#endif  // REIN_LOG_ROTATING_APPENDER_H_
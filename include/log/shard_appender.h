@@ -0,0 +1,87 @@
+#ifndef REIN_LOG_SHARD_APPENDER_H_
+#define REIN_LOG_SHARD_APPENDER_H_
+
+#include <sys/types.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "appender.h"
+#include "log_constants.h"
+
+namespace rein {
+namespace log {
+
+/*
+  按线程分片的文件输出地：产生日志的每个线程写自己的文件 <name>.<tid>.log
+  （name 以 .log 结尾时先去掉，app.log -> app.12345.log）。
+  每个分片有独立的缓冲区和锁，线程只碰自己的分片，分片在线程内缓存，写入路径没有线程间的竞争；
+  只有 Flush()（显式调用或定时刷新）会短暂地与写线程争用同一分片的锁。
+  分片的依据是事件的产生线程，异步模式下后台线程同样按产生线程写入对应分片。
+  分片文件在 Appender 析构时关闭。合并为一个按时间排序的文件用 MergeShards() 或 rein_log_merge。
+*/
+class ShardedFileAppender final : public Appender {
+public:
+    explicit ShardedFileAppender(const std::string& name);
+    ~ShardedFileAppender() override;
+
+    void Log(const std::shared_ptr<LogEvent> event, Level level) override;
+    void Write(const std::shared_ptr<LogEvent>& event, fmt::string_view formatted) override;
+    bool SupportsPreformatted() const override { return true; }
+    void Flush() override;
+
+    void SetBufferSize(size_t bytes);
+    void SetFlushInterval(std::chrono::milliseconds interval);
+    void SetFlushLevel(LevelType level);
+
+    // 已经创建的分片文件
+    std::vector<std::string> shards() const;
+
+    // 线程 tid 的分片文件名
+    static std::string ShardName(const std::string& name, pid_t tid);
+
+private:
+    struct Shard {
+        std::mutex mutex;
+        int fd = -1;
+        std::string file;
+        fmt::memory_buffer buffer;  // 受 mutex 保护
+    };
+
+    Shard* ShardFor(pid_t tid);
+    void Append(Shard& shard, const LogEvent& event);
+    void FlushShardLocked(Shard& shard);
+
+private:
+    std::string file_name_;
+    const uint64_t id_;  // 区分线程内缓存的归属
+    std::unordered_map<pid_t, std::unique_ptr<Shard>> shards_;  // 受 mutex_ 保护
+    std::atomic<size_t> buffer_size_{kDefaultFileBufferSize};
+    std::atomic<LevelType> flush_level_{LevelType::kError};
+};
+
+// name 对应的全部分片文件，按文件名排序
+std::vector<std::string> FindShards(const std::string& name);
+
+/**
+ * @brief 把多个分片按行首时间戳 k 路归并，写到 out，返回写出的行数。
+ * 排序键是行首由数字和 "-:. T" 组成的前缀，布局须以定宽的 %d 开头（默认布局满足）；
+ * 键相同时按 files 中的顺序输出，同一分片内的顺序保持不变。
+ * 每个输入只占一行的缓冲；输入超过 fan_in 个时先分组归并到临时文件，再归并这些临时文件。
+ * 打开输入失败时抛出 std::runtime_error。
+ */
+size_t MergeShards(const std::vector<std::string>& files,
+                   std::FILE* out,
+                   size_t fan_in = kDefaultMergeFanIn);
+
+}  // namespace log
+}  // namespace rein
+
+#endif  // REIN_LOG_SHARD_APPENDER_H_
@@ -0,0 +1,94 @@
+#ifndef REIN_LOG_SHM_APPENDER_H_
+#define REIN_LOG_SHM_APPENDER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "appender.h"
+#include "log_constants.h"
+
+namespace rein {
+namespace log {
+
+/*
+  共享内存环形缓冲区的布局（shm_open 的对象，所有进程按同样的方式映射）：
+    ShmRingHeader       魔数、版本、数据区偏移与容量、所有生产者共享的写位置 head
+    数据区              capacity 字节（2 的幂），记录首尾相接，可以跨越数据区末尾绕回开头
+  位置（序号）是记录在无限长字节流中的偏移，只增不减；数据区下标为 位置 & (capacity - 1)。
+  每条记录按 8 字节对齐：
+    提交字     记录位置 + 1，最后以 release 写入；读者看到与期望位置相符的提交字才读这条记录
+    长度字     低 32 位为内容字节数，之后 16 位为记录类型（kShmRecordText 等）
+    校验字     ShmRecordChecksum(位置, 内容)
+    内容       按 8 字节补齐
+  生产者用 fetch_add 在 head 上无锁预留空间，不等待读者：读者太慢时记录被覆盖，
+  读者复制完内容后再检查 head，确认这段数据在复制期间没有被新一圈的写入覆盖。
+  预留之后被调度出去、醒来时已经被套圈的生产者仍会写入旧位置，破坏较新的记录，
+  这种情况 head 看不出来，由校验字发现。
+*/
+struct ShmRingHeader {
+    char magic[8];           // kShmRingMagic，初始化完成后最后写入
+    uint32_t version;
+    uint32_t data_offset;    // 数据区相对映射起点的偏移
+    uint64_t capacity;       // 数据区字节数
+    alignas(64) std::atomic<uint64_t> head;  // 下一条记录的位置
+};
+
+constexpr char kShmRingMagic[8] = {'R', 'E', 'I', 'N', 'S', 'H', 'M', 'R'};
+constexpr uint32_t kShmRingVersion = 1;
+constexpr size_t kShmRecordHeaderSize = 24;  // 提交字 + 长度字 + 校验字
+constexpr uint16_t kShmRecordText = 0;       // 按布局渲染的文本
+constexpr uint16_t kShmRecordBinary = 1;     // Publish() 写入的应用自定义二进制记录
+
+// 记录内容的校验值，以记录位置为种子，旧一圈残留的数据也对不上
+uint64_t ShmRecordChecksum(uint64_t position, const char* data, size_t size);
+
+/*
+  共享内存输出地：把按布局渲染好的日志（或 Publish() 给出的二进制记录）发布到命名的共享内存环中，
+  供本机的日志采集进程用 ShmRingReader 直接读取，不经过磁盘，每条记录没有系统调用。
+  写入路径不加锁，同一个环可以由多个线程、多个进程同时写入；读者落后超过一圈时由读者检测并计数，
+  应用从不等待读者。没有读者时记录只是被不断覆盖。
+  共享内存对象不随 Appender 删除，以便重启后的进程与采集进程继续使用；需要时调用 Remove()。
+*/
+class ShmRingAppender final : public Appender {
+public:
+    // name 为共享内存对象名（"/rein_log"，缺少前导 '/' 时自动补上）。
+    // 对象已存在时沿用它的容量；创建或映射失败、对象不是日志环时抛出 std::runtime_error
+    explicit ShmRingAppender(const std::string& name, size_t capacity = kDefaultShmRingSize);
+    ~ShmRingAppender() override;
+
+    void Log(const std::shared_ptr<LogEvent> event, Level level) override;
+    void Write(const std::shared_ptr<LogEvent>& event, fmt::string_view formatted) override;
+    bool SupportsPreformatted() const override { return true; }
+
+    // 发布一条任意内容的记录；超过容量的记录被丢弃并返回 false
+    bool Publish(const void* data, size_t size, uint16_t type = kShmRecordBinary);
+
+    const std::string& shm_name() const { return shm_name_; }
+    size_t capacity() const { return capacity_; }
+    // 因超过环容量而丢弃的记录数
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+    // 删除共享内存对象（已经映射的进程不受影响）
+    static bool Remove(const std::string& name);
+
+    // 规范化的共享内存对象名
+    static std::string ShmName(const std::string& name);
+
+private:
+    void Open(size_t capacity);
+
+private:
+    std::string shm_name_;
+    size_t capacity_ = 0;
+    size_t mapped_size_ = 0;
+    ShmRingHeader* header_ = nullptr;
+    char* data_ = nullptr;
+    std::atomic<uint64_t> dropped_{0};
+};
+
+}  // namespace log
+}  // namespace rein
+
+#endif  // REIN_LOG_SHM_APPENDER_H_
@@ -0,0 +1,66 @@
+#ifndef REIN_LOG_SHM_READER_H_
+#define REIN_LOG_SHM_READER_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "shm_appender.h"
+
+namespace rein {
+namespace log {
+
+struct ShmRecord {
+    uint16_t type = kShmRecordText;
+    uint64_t position = 0;    // 记录在流中的位置
+    fmt::string_view data;    // 指向读取器内部的缓冲区，下一次 Next() 之前有效
+};
+
+/*
+  ShmRingAppender 写出的共享内存环的读取端，只读映射，不修改共享内存，可以有任意多个读者互不影响。
+  Next() 只读内存，不做系统调用；没有新记录时返回 false，由调用方决定如何等待。
+  打开时环还没有绕回过则从第一条记录开始读，否则从当前写位置开始。
+  落后超过一圈（记录在读取前或读取中被覆盖）或记录校验失败时计一次 overrun，跳到当前写位置继续，
+  跳过的字节数计入 lost_bytes()。
+*/
+class ShmRingReader {
+public:
+    // 对象不存在或不是日志环时抛出 std::runtime_error
+    explicit ShmRingReader(const std::string& name);
+    ~ShmRingReader();
+
+    ShmRingReader(const ShmRingReader&) = delete;
+    ShmRingReader& operator=(const ShmRingReader&) = delete;
+
+    bool Next(ShmRecord& record);
+
+    uint64_t position() const { return position_; }
+    // 写位置减去读位置，即尚未读取（或已经丢失）的字节数
+    uint64_t lag() const;
+    uint64_t overruns() const { return overruns_; }
+    uint64_t lost_bytes() const { return lost_bytes_; }
+    size_t capacity() const { return capacity_; }
+
+private:
+    // 复制 [position, position + size) 到 out
+    void CopyOut(uint64_t position, char* out, size_t size) const;
+    void Resync(uint64_t head);
+
+private:
+    std::string shm_name_;
+    size_t capacity_ = 0;
+    size_t mapped_size_ = 0;
+    const ShmRingHeader* header_ = nullptr;
+    const char* data_ = nullptr;
+    uint64_t position_ = 0;
+    uint64_t overruns_ = 0;
+    uint64_t lost_bytes_ = 0;
+    std::vector<char> buffer_;
+};
+
+}  // namespace log
+}  // namespace rein
+
+#endif  // REIN_LOG_SHM_READER_H_
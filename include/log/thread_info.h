@@ -0,0 +1,50 @@
+#ifndef REIN_LOG_THREAD_INFO_H_
+#define REIN_LOG_THREAD_INFO_H_
+
+#include <pthread.h>
+#include <sys/types.h>
+
+#include <memory>
+#include <string>
+
+namespace rein {
+namespace log {
+
+/*
+  线程身份信息：内核线程号（gettid）、pthread_t 和线程名。
+  每个线程第一次打日志时解析一次并缓存在 thread_local 中，之后的事件只持有它的引用。
+  对象创建后不再修改：重命名时换成新对象，已在异步队列中的事件仍看到旧名字。
+*/
+class ThreadInfo {
+public:
+    // 当前线程的缓存，首次调用时创建
+    static const std::shared_ptr<const ThreadInfo>& Current();
+
+    // 线程通过 pthread_setname_np/prctl 自行改名后调用，重新读取线程名
+    static void Refresh();
+
+    // 设置当前线程名（超过 15 字符会被截断）并刷新缓存
+    static void SetName(const std::string& name);
+
+    // 构造一个指定身份的对象，用于回放其他进程记录的事件
+    static std::shared_ptr<const ThreadInfo> Make(pid_t tid, pthread_t pthread_id, const char* name);
+
+    // 内核线程号，与 top/perf/ps -L 中看到的一致
+    pid_t tid() const { return tid_; }
+    pthread_t pthread_id() const { return pthread_id_; }
+    const char* name() const { return name_; }
+
+private:
+    ThreadInfo();
+    ThreadInfo(pid_t tid, pthread_t pthread_id, const char* name);
+
+private:
+    pid_t tid_;
+    pthread_t pthread_id_;
+    char name_[16];  // Linux 线程名限制 15 字符
+};
+
+}  // namespace log
+}  // namespace rein
+
+#endif  // REIN_LOG_THREAD_INFO_H_
@@ -1,5 +1,9 @@
 #include "log/appender.h"
 
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
 #include <cerrno>
 #include <cstdio>
 #include <cstring>
@@ -8,14 +12,72 @@
 #include <stdexcept>
 
 #include "fmt/base.h"
+#include "log/binary_appender.h"
 #include "log/color.h"
+#include "log/dedup_appender.h"
+#include "log/durable_appender.h"
 #include "log/event.h"
+#include "log/flight_appender.h"
+#include "log/flush_scheduler.h"
 #include "log/layout.h"
 #include "log/level.h"
+#include "log/mmap_appender.h"
+#include "log/net_appender.h"
+#include "log/rotating_appender.h"
+#include "log/shard_appender.h"
+#include "log/shm_appender.h"
+#include "log/uring_appender.h"
 
 namespace rein {
 namespace log {
 
+namespace {
+
+void Append(fmt::memory_buffer& buffer, const char* str) {
+    buffer.append(str, str + std::strlen(str));
+}
+
+// 写完 iov 中的全部数据，处理 EINTR 与短写（会修改 iov）
+bool WriteVAll(int fd, struct iovec* iov, int count) {
+    while (count > 0) {
+        ssize_t n = ::writev(fd, iov, count);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        while (count > 0 && static_cast<size_t>(n) >= iov->iov_len) {
+            n -= static_cast<ssize_t>(iov->iov_len);
+            ++iov;
+            --count;
+        }
+        if (count > 0) {
+            iov->iov_base = static_cast<char*>(iov->iov_base) + n;
+            iov->iov_len -= static_cast<size_t>(n);
+        }
+    }
+    return true;
+}
+
+// 写满 size 字节，处理 EINTR 与短写
+bool WriteAll(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t n = ::write(fd, data, size);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+}  // namespace
+
 Appender::Appender(AppenderType type, const std::string& name)
     : type_(type),
       name_(name),
@@ -27,10 +89,11 @@ void Appender::SetLayout(std::shared_ptr<Layout> layout) {
 }
 
 void Appender::SetLayout(const std::string& param) {
-    layout_ = param.empty() ? std::make_shared<Layout>() : std::make_shared<Layout>(param);
+    // 解析布局不需要持锁，只在替换指针时加锁
+    SetLayout(param.empty() ? std::make_shared<Layout>() : std::make_shared<Layout>(param));
 }
 
-void Appender::SetLayout() { layout_ = std::make_shared<Layout>(); }
+void Appender::SetLayout() { SetLayout(std::make_shared<Layout>()); }
 
 void Appender::SetName(const std::string& name) { name_ = name; }
 
@@ -41,38 +104,142 @@ Level Appender::level() const { return level_; }
 AppenderType Appender::type() const { return type_; };
 
 std::string Appender::type_str() const { return AppenderFactory::TypeToString(type_); }
-std::shared_ptr<Layout> Appender::layout() const { return layout_; }
+std::shared_ptr<Layout> Appender::layout() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return layout_;
+}
 
 FileAppender::FileAppender(const std::string& name)
-    : Appender(AppenderType::FILE, name),  // 调用基类构造，初始化 type_ 为 FILE
+    : FileAppender(AppenderType::FILE, name) {}  // 初始化 type_ 为 FILE
+
+FileAppender::FileAppender(AppenderType type, const std::string& name)
+    : Appender(type, name),
       file_name_(name) {
     SetLayout();
+    buffer_.reserve(buffer_size_ * 2);
     Open();
     if (!IsOpen()) {
         fmt::println("FileAppender construction failed!");
     }
 }
-FileAppender::~FileAppender() { Close(); }
+FileAppender::~FileAppender() {
+    FlushScheduler::instance().Unregister(this);
+    Close();
+}
 
 void FileAppender::Log(const std::shared_ptr<LogEvent> event, Level level) {
-    if (!IsOpen()) {
+    if (!level.cmp(event->level())) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (fd_ < 0) {
+        fmt::println("File is not opened! Please open file...");
+        return;
+    }
+
+    // 直接追加到自己的写缓冲区，攒够一批再交给内核
+    layout_->format(buffer_, event);
+    if (buffer_.size() >= buffer_size_ || event->level().level() >= flush_level_) {
+        FlushLocked();
+    }
+}
+
+void FileAppender::Write(const std::shared_ptr<LogEvent>& event, fmt::string_view formatted) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (fd_ < 0) {
         fmt::println("File is not opened! Please open file...");
         return;
     }
+    AppendLocked(event, formatted);
+}
+
+void FileAppender::AppendLocked(const std::shared_ptr<LogEvent>& event,
+                                fmt::string_view formatted) {
+    if (buffer_.size() + formatted.size() >= buffer_size_) {
+        // 缓冲区放不下：已有数据和这条日志用一次 writev 写出，不再拷贝进缓冲区
+        struct iovec iov[2];
+        iov[0].iov_base = buffer_.data();
+        iov[0].iov_len = buffer_.size();
+        iov[1].iov_base = const_cast<char*>(formatted.data());
+        iov[1].iov_len = formatted.size();
+        if (!WriteVAll(fd_, iov, 2)) {
+            fmt::println(stderr, "Write to file '{}' failed, error: {}", file_name_,
+                         std::strerror(errno));
+        }
+        buffer_.clear();
+        return;
+    }
+
+    buffer_.append(formatted.data(), formatted.data() + formatted.size());
+    if (event->level().level() >= flush_level_) {
+        FlushLocked();
+    }
+}
+
+void FileAppender::Flush() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    FlushLocked();
+}
+
+void FileAppender::SetBufferSize(size_t bytes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    FlushLocked();
+    buffer_size_ = bytes;
+    buffer_.reserve(bytes * 2);
+}
+
+void FileAppender::SetFlushInterval(std::chrono::milliseconds interval) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        flush_interval_ = interval;
+    }
+    // 调度器在自己的锁内调用 Flush()，注册/注销不能持有 mutex_
+    if (interval.count() > 0) {
+        FlushScheduler::instance().Register(this, interval);
+    } else {
+        FlushScheduler::instance().Unregister(this);
+    }
+}
+
+void FileAppender::SetFlushLevel(LevelType level) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    flush_level_ = level;
+}
 
+size_t FileAppender::buffer_size() const {
     std::lock_guard<std::mutex> lock(mutex_);
-    fmt::print(file_, layout_->format(event));
+    return buffer_size_;
+}
+
+std::chrono::milliseconds FileAppender::flush_interval() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return flush_interval_;
+}
+
+LevelType FileAppender::flush_level() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return flush_level_;
+}
+
+void FileAppender::FlushLocked() {
+    if (fd_ >= 0 && buffer_.size() > 0 && !WriteAll(fd_, buffer_.data(), buffer_.size())) {
+        fmt::println(stderr, "Write to file '{}' failed, error: {}", file_name_,
+                     std::strerror(errno));
+    }
+    buffer_.clear();
+}
+
+int FileAppender::OpenFile(const std::string& name) {
+    return ::open(name.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC,
+                  0644);  // 追加+创建文件
 }
 
 void FileAppender::Open() {
-    // std::lock_guard<std::mutex> lock(mutex_);
     // 使用的两个地方：构造（不需要加锁），Reopen 已经加锁
-    file_ = std::fopen(file_name_.c_str(), "a+");  // 追加+创建文件
-
-    if (!file_) {
-        // fmt::println(stderr, "Could not open or create file '{}', error: {}", file_name_,
-        //              std::strerror(errno));
+    fd_ = OpenFile(file_name_);
 
+    if (fd_ < 0) {
         throw std::runtime_error(fmt::format("Could not open or create file '{}', error: {}",
                                              file_name_, std::strerror(errno)));
     }
@@ -80,22 +247,32 @@ void FileAppender::Open() {
 
 void FileAppender::Close() {
     std::lock_guard<std::mutex> lock(mutex_);
-    if (!file_) {
+    CloseLocked();
+}
+
+void FileAppender::CloseLocked() {
+    if (fd_ < 0) {
         return;
     }
-    std::fclose(file_);
-    file_ = nullptr;
+    FlushLocked();
+    ::close(fd_);
+    fd_ = -1;
 }
 
 void FileAppender::ReOpen() {
     std::lock_guard<std::mutex> lock(mutex_);
-    Close();
+    CloseLocked();
     Open();
 }
 
 bool FileAppender::IsOpen() const {
     std::lock_guard<std::mutex> lock(mutex_);
-    return file_ != nullptr;
+    return fd_ >= 0;
+}
+
+std::string FileAppender::file() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return file_name_;
 }
 
 ConsoleAppender::ConsoleAppender()
@@ -109,21 +286,31 @@ ConsoleAppender::ConsoleAppender(const std::string& name)
 }
 
 void ConsoleAppender::Log(const std::shared_ptr<LogEvent> event, Level level) {
+    if (!level.cmp(event->level())) {
+        return;
+    }
+
     std::lock_guard<std::mutex> lock(mutex_);
-    fmt::print(stdout, "{}{}{}",
-               rein::color::get_level_color(event->level()),  // 级别对应颜色
-               layout_->format(event),                        // 日志内容
-               rein::color::Color::RESET                      // 重置颜色
-    );
+    buffer_.clear();
+    Append(buffer_, rein::color::get_level_color(event->level()));  // 级别对应颜色
+    layout_->format(buffer_, event);                                // 日志内容
+    Append(buffer_, rein::color::Color::RESET);                     // 重置颜色
+    WriteLocked();
 }
 
-NetAppender::NetAppender(const std::string& address)
-    : Appender(AppenderType::NET, address) {
-    SetLayout();
+void ConsoleAppender::Write(const std::shared_ptr<LogEvent>& event, fmt::string_view formatted) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    buffer_.clear();
+    Append(buffer_, rein::color::get_level_color(event->level()));
+    buffer_.append(formatted.data(), formatted.data() + formatted.size());
+    Append(buffer_, rein::color::Color::RESET);
+    WriteLocked();
 }
 
-void NetAppender::Log(const std::shared_ptr<LogEvent> event, Level level) {
-    fmt::println("This is NetAppender Log");
+void ConsoleAppender::WriteLocked() {
+    // 先清空 stdio 中用户自己 printf 的内容，保证输出顺序；随后绕过 stdio 直接写
+    std::fflush(stdout);
+    WriteAll(STDOUT_FILENO, buffer_.data(), buffer_.size());
 }
 
 std::shared_ptr<Appender> AppenderFactory::CreateAppender(AppenderType type,
@@ -139,8 +326,62 @@ std::shared_ptr<Appender> AppenderFactory::CreateAppender(AppenderType type,
             }
             return std::make_shared<FileAppender>(name);
         case AppenderType::NET:
-            // 网络输出器可根据名称参数配置地址等信息
+            // 网络输出器需要 [tcp://|udp://]host:port 形式的地址
+            if (name.empty()) {
+                return nullptr;
+            }
             return std::make_shared<NetAppender>(name);
+        case AppenderType::MMAP:
+            // 内存映射文件输出器同样需要文件名
+            if (name.empty()) {
+                return nullptr;
+            }
+            return std::make_shared<MmapFileAppender>(name);
+        case AppenderType::ROTATING:
+            // 滚动文件输出器使用默认的滚动策略，可再通过 SetPolicy() 调整
+            if (name.empty()) {
+                return nullptr;
+            }
+            return std::make_shared<RotatingFileAppender>(name);
+        case AppenderType::URING:
+            // io_uring 不可用时自动退回同步写
+            if (name.empty()) {
+                return nullptr;
+            }
+            return std::make_shared<UringFileAppender>(name);
+        case AppenderType::DURABLE:
+            // 默认阻塞到落盘
+            if (name.empty()) {
+                return nullptr;
+            }
+            return std::make_shared<DurableFileAppender>(name);
+        case AppenderType::BINARY:
+            // 二进制文件，用 rein_log_decode 还原为文本
+            if (name.empty()) {
+                return nullptr;
+            }
+            return std::make_shared<BinaryFileAppender>(name);
+        case AppenderType::SHARDED:
+            // name 是分片文件名的前缀
+            if (name.empty()) {
+                return nullptr;
+            }
+            return std::make_shared<ShardedFileAppender>(name);
+        case AppenderType::SHM:
+            // name 是共享内存对象名，使用默认容量
+            if (name.empty()) {
+                return nullptr;
+            }
+            return std::make_shared<ShmRingAppender>(name);
+        case AppenderType::FLIGHT:
+            // name 是写出的目标文件，默认（console）写到 stderr
+            return std::make_shared<FlightRecorderAppender>(name == kConsole ? "" : name);
+        case AppenderType::DEDUP:
+            // 折叠控制台或文件输出中的重复消息
+            if (name == kConsole) {
+                return std::make_shared<DedupAppender>(std::make_shared<ConsoleAppender>(name));
+            }
+            return std::make_shared<DedupAppender>(std::make_shared<FileAppender>(name));
         default:
             return nullptr;
     }
@@ -153,6 +394,24 @@ AppenderType AppenderFactory::StringToType(const std::string& type_name) {
         return AppenderType::FILE;
     } else if (type_name == "net") {
         return AppenderType::NET;
+    } else if (type_name == "mmap") {
+        return AppenderType::MMAP;
+    } else if (type_name == "rotating") {
+        return AppenderType::ROTATING;
+    } else if (type_name == "uring") {
+        return AppenderType::URING;
+    } else if (type_name == "durable") {
+        return AppenderType::DURABLE;
+    } else if (type_name == "binary") {
+        return AppenderType::BINARY;
+    } else if (type_name == "sharded") {
+        return AppenderType::SHARDED;
+    } else if (type_name == "shm") {
+        return AppenderType::SHM;
+    } else if (type_name == "flight") {
+        return AppenderType::FLIGHT;
+    } else if (type_name == "dedup") {
+        return AppenderType::DEDUP;
     } else {
         // throw std::invalid_argument(
         //     fmt::format("Appender with name '{}' is not exists.", type_name));
@@ -168,6 +427,24 @@ std::string AppenderFactory::TypeToString(AppenderType type) {
             return "file";
         case AppenderType::NET:
             return "net";
+        case AppenderType::MMAP:
+            return "mmap";
+        case AppenderType::ROTATING:
+            return "rotating";
+        case AppenderType::URING:
+            return "uring";
+        case AppenderType::DURABLE:
+            return "durable";
+        case AppenderType::BINARY:
+            return "binary";
+        case AppenderType::SHARDED:
+            return "sharded";
+        case AppenderType::SHM:
+            return "shm";
+        case AppenderType::FLIGHT:
+            return "flight";
+        case AppenderType::DEDUP:
+            return "dedup";
         default:
             throw std::invalid_argument(fmt::format("AppenderType is not exists"));
     }
@@ -0,0 +1,76 @@
+#include "log/arg_record.h"
+
+#include <iterator>  // for std::back_inserter
+
+#include <fmt/args.h>
+
+namespace rein {
+namespace log {
+
+namespace {
+
+template <typename T>
+T ReadValue(const char *&cursor) {
+    T value;
+    std::memcpy(&value, cursor, sizeof(T));
+    cursor += sizeof(T);
+    return value;
+}
+
+}  // namespace
+
+void ArgRecord::Format(fmt::memory_buffer &out) const {
+    // 每个线程复用一个参数表，字符串以 string_view 形式引用记录内的字节，不再拷贝
+    thread_local fmt::dynamic_format_arg_store<fmt::format_context> store;
+    store.clear();
+
+    const char *cursor = data_.data();
+    const char *end = cursor + data_.size();
+    while (cursor < end) {
+        auto type = static_cast<ArgType>(*cursor++);
+        switch (type) {
+            case ArgType::kBool:
+                store.push_back(ReadValue<bool>(cursor));
+                break;
+            case ArgType::kChar:
+                store.push_back(ReadValue<char>(cursor));
+                break;
+            case ArgType::kInt:
+                store.push_back(ReadValue<int64_t>(cursor));
+                break;
+            case ArgType::kUint:
+                store.push_back(ReadValue<uint64_t>(cursor));
+                break;
+            case ArgType::kFloat:
+                store.push_back(ReadValue<float>(cursor));
+                break;
+            case ArgType::kDouble:
+                store.push_back(ReadValue<double>(cursor));
+                break;
+            case ArgType::kPointer:
+                store.push_back(ReadValue<const void *>(cursor));
+                break;
+            case ArgType::kString: {
+                auto size = ReadValue<uint32_t>(cursor);
+                store.push_back(fmt::string_view(cursor, size));
+                cursor += size;
+                break;
+            }
+            default:
+                cursor = end;  // 损坏的记录，丢弃剩余参数
+                break;
+        }
+    }
+
+    const size_t start = out.size();
+    try {
+        fmt::vformat_to(std::back_inserter(out), format_, store);
+    } catch (const fmt::format_error &e) {
+        // 渲染可能发生在后台线程，不能让异常把线程带走
+        out.resize(start);
+        fmt::format_to(std::back_inserter(out), "[format error: {}] {}", e.what(), format_);
+    }
+}
+
+}  // namespace log
+}  // namespace rein
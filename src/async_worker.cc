@@ -0,0 +1,160 @@
+#include "log/async_worker.h"
+
+#include <chrono>
+#include <utility>
+
+#include "log/logger.h"
+
+namespace rein {
+namespace log {
+
+// 后台线程空闲时的最长休眠时间，作为漏唤醒的兜底
+constexpr auto kIdleWait = std::chrono::milliseconds(50);
+
+AsyncWorker::AsyncWorker(size_t capacity, OverflowPolicy policy)
+    : queue_(capacity),
+      policy_(policy),
+      pushed_(0),
+      done_(0),
+      dropped_(0),
+      sleeping_(false),
+      stop_(false),
+      finished_(false) {
+    thread_ = std::thread(&AsyncWorker::Run, this);
+    thread_id_ = thread_.get_id();
+}
+
+AsyncWorker::~AsyncWorker() { Stop(); }
+
+void AsyncWorker::Push(std::shared_ptr<LogEvent> event) {
+    if (stop_.load(std::memory_order_acquire)) {
+        Dispatch(event);
+        return;
+    }
+
+    while (!queue_.TryPush(event)) {
+        switch (policy_) {
+            case OverflowPolicy::kDropNewest:
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return;
+            case OverflowPolicy::kDropOldest: {
+                std::shared_ptr<LogEvent> oldest;
+                if (queue_.TryPop(oldest)) {
+                    dropped_.fetch_add(1, std::memory_order_relaxed);
+                    done_.fetch_add(1, std::memory_order_release);
+                }
+                break;
+            }
+            case OverflowPolicy::kBlock:
+            default:
+                if (stop_.load(std::memory_order_acquire)) {
+                    Dispatch(event);
+                    return;
+                }
+                Wake();
+                std::this_thread::yield();
+                break;
+        }
+    }
+    pushed_.fetch_add(1, std::memory_order_release);
+
+    // 与 Run() 中 sleeping_ 的写入配对，保证不会漏掉唤醒
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sleeping_.load(std::memory_order_relaxed)) {
+        Wake();
+    }
+
+    // 与 Stop() 竞争时，由生产者自己把残留的日志输出掉
+    if (stop_.load(std::memory_order_acquire)) {
+        Drain();
+    }
+}
+
+void AsyncWorker::Flush() {
+    if (std::this_thread::get_id() == thread_id_) {
+        return;  // Appender 内部再次打日志，避免自己等自己
+    }
+
+    const uint64_t target = pushed_.load(std::memory_order_acquire);
+    std::unique_lock<std::mutex> lock(mutex_);
+    wake_cv_.notify_one();
+    done_cv_.wait(lock, [&]() {
+        return done_.load(std::memory_order_acquire) >= target || finished_;
+    });
+}
+
+void AsyncWorker::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stop_.exchange(true)) {
+            return;
+        }
+        wake_cv_.notify_one();
+    }
+
+    if (thread_.joinable()) {
+        if (std::this_thread::get_id() == thread_id_) {
+            thread_.detach();
+        } else {
+            thread_.join();
+        }
+    }
+    Drain();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    finished_ = true;
+    done_cv_.notify_all();
+}
+
+uint64_t AsyncWorker::dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+OverflowPolicy AsyncWorker::policy() const { return policy_; }
+
+size_t AsyncWorker::capacity() const { return queue_.capacity(); }
+
+void AsyncWorker::Run() {
+    for (;;) {
+        Drain();
+
+        if (stop_.load(std::memory_order_acquire) && queue_.size() == 0) {
+            break;
+        }
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        sleeping_.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (queue_.size() == 0 && !stop_.load(std::memory_order_acquire)) {
+            wake_cv_.wait_for(lock, kIdleWait);
+        }
+        sleeping_.store(false, std::memory_order_relaxed);
+    }
+}
+
+void AsyncWorker::Drain() {
+    bool drained = false;
+    std::shared_ptr<LogEvent> event;
+    while (queue_.TryPop(event)) {
+        Dispatch(event);
+        event.reset();
+        done_.fetch_add(1, std::memory_order_release);
+        drained = true;
+    }
+
+    if (drained) {
+        // 每批只加一次锁通知 Flush 的等待者
+        std::lock_guard<std::mutex> lock(mutex_);
+        done_cv_.notify_all();
+    }
+}
+
+void AsyncWorker::Dispatch(const std::shared_ptr<LogEvent>& event) {
+    event->logger()->CallAppenders(event);
+}
+
+void AsyncWorker::Wake() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    wake_cv_.notify_one();
+}
+
+}  // namespace log
+}  // namespace rein
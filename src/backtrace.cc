@@ -0,0 +1,110 @@
+#include "log/backtrace.h"
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "log/event.h"
+#include "log/logger.h"
+#include "log/object_pool.hpp"
+
+namespace rein {
+namespace log {
+
+thread_local std::vector<std::unique_ptr<BacktraceScope::Buffer>> BacktraceScope::spare_buffers_;
+
+BacktraceScope::BacktraceScope(LevelType threshold, LevelType trigger, size_t events)
+    : previous_(detail::Backtrace()) {
+    events = std::max<size_t>(events, 1);
+    auto& spare = spare_buffers_;
+    if (!spare.empty()) {
+        buffer_ = std::move(spare.back());
+        spare.pop_back();
+    } else {
+        buffer_.reset(new Buffer());
+    }
+    if (buffer_->entries.size() != events) {
+        buffer_->entries.resize(events);
+    }
+
+    detail::BacktraceState& state = detail::Backtrace();
+    state.threshold = threshold;
+    state.trigger = trigger;
+    state.scope = this;
+    detail::BacktraceScopes().fetch_add(1, std::memory_order_relaxed);
+}
+
+BacktraceScope::~BacktraceScope() {
+    detail::BacktraceScopes().fetch_sub(1, std::memory_order_relaxed);
+    detail::Backtrace() = previous_;
+    buffer_->loggers.clear();
+    spare_buffers_.push_back(std::move(buffer_));
+}
+
+BacktraceScope::Entry& BacktraceScope::Claim(
+    Logger* logger, Level level, const char* file, uint32_t line, const char* func) {
+    // 同一作用域内通常只有一两个 Logger，只在换 Logger 时才查表并增加引用计数
+    if (logger != last_logger_) {
+        auto& loggers = buffer_->loggers;
+        auto it = std::find_if(loggers.begin(), loggers.end(),
+                               [&](const std::shared_ptr<Logger>& held) {
+                                   return held.get() == logger;
+                               });
+        if (it == loggers.end()) {
+            loggers.push_back(logger->shared_from_this());
+        }
+        last_logger_ = logger;
+    }
+
+    auto& entries = buffer_->entries;
+    if (size_ == entries.size()) {
+        // 已满：先淘汰最旧的一条再复用它的槽位，编码失败时不会留下半写的事件
+        head_ = (head_ + 1) % entries.size();
+        --size_;
+        ++dropped_;
+    }
+    Entry& entry = entries[(head_ + size_) % entries.size()];
+    entry.logger = logger;
+    entry.level = level;
+    entry.line = line;
+    entry.file = file;
+    entry.function = func;
+    entry.stamp = Clock::Now();
+    entry.data.clear();
+    return entry;
+}
+
+void BacktraceScope::Commit() {
+    ++size_;
+}
+
+void BacktraceScope::Flush() {
+    // 输出期间 Appender 自己打的日志不再进入缓冲区
+    struct Suspend {
+        detail::BacktraceState saved = detail::Backtrace();
+        Suspend() { detail::Backtrace() = {LevelType::kUnknown, LevelType::kUnknown, nullptr}; }
+        ~Suspend() { detail::Backtrace() = saved; }
+    } suspend;
+
+    auto& entries = buffer_->entries;
+    const auto& thread = ThreadInfo::Current();
+    while (size_ > 0) {
+        Entry& entry = entries[head_];
+        head_ = (head_ + 1) % entries.size();
+        --size_;
+        auto event = std::allocate_shared<LogEvent>(
+            PoolAllocator<LogEvent>(), entry.level, entry.file, entry.line, entry.function,
+            entry.stamp, thread, entry.logger->shared_from_this());
+        event->Assign(entry.format, fmt::string_view(entry.data.data(), entry.data.size()));
+        entry.logger->Post(std::move(event));
+    }
+    head_ = 0;
+}
+
+void BacktraceScope::Clear() {
+    head_ = 0;
+    size_ = 0;
+}
+
+}  // namespace log
+}  // namespace rein
@@ -0,0 +1,314 @@
+#include "log/binary_appender.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+
+#include "log/clock.h"
+#include "log/event.h"
+#include "log/logger.h"
+
+namespace rein {
+namespace log {
+
+namespace {
+
+char *EncodeVarint(char *out, uint64_t value) {
+    while (value >= 0x80) {
+        *out++ = static_cast<char>(value | 0x80);
+        value >>= 7;
+    }
+    *out++ = static_cast<char>(value);
+    return out;
+}
+
+void PutVarint(fmt::memory_buffer &out, uint64_t value) {
+    char bytes[10];
+    out.append(bytes, EncodeVarint(bytes, value));
+}
+
+uint64_t ZigZag(int64_t value) {
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+void PutByte(fmt::memory_buffer &out, uint8_t value) { out.push_back(static_cast<char>(value)); }
+
+void PutString(fmt::memory_buffer &out, const char *data, size_t size) {
+    PutVarint(out, size);
+    out.append(data, data + size);
+}
+
+void PutString(fmt::memory_buffer &out, const char *str) {
+    PutString(out, str ? str : "", str ? std::strlen(str) : 0);
+}
+
+template <typename T>
+T ReadValue(const char *&cursor) {
+    T value;
+    std::memcpy(&value, cursor, sizeof(T));
+    cursor += sizeof(T);
+    return value;
+}
+
+/*
+  把 ArgRecord 的定长编码转成紧凑编码：类型标签写入 types，只把值写入 out。
+  整数 8 字节 -> 变长，字符串长度 4 字节 -> 变长。
+  编码后不会超过原长度的两倍，先按此预留再直接写指针，避免逐个字段调用 append。
+*/
+void EncodeArgs(fmt::string_view data, fmt::memory_buffer &types, fmt::memory_buffer &out) {
+    types.resize(data.size());
+    out.resize(data.size() * 2);
+    char *type_out = types.data();
+    char *value_out = out.data();
+
+    const char *cursor = data.data();
+    const char *end = cursor + data.size();
+    while (cursor < end) {
+        auto type = static_cast<ArgType>(*cursor++);
+        *type_out++ = static_cast<char>(type);
+        switch (type) {
+            case ArgType::kBool:
+            case ArgType::kChar:
+                *value_out++ = *cursor++;
+                break;
+            case ArgType::kInt:
+                value_out = EncodeVarint(value_out, ZigZag(ReadValue<int64_t>(cursor)));
+                break;
+            case ArgType::kUint:
+                value_out = EncodeVarint(value_out, ReadValue<uint64_t>(cursor));
+                break;
+            case ArgType::kFloat:
+                std::memcpy(value_out, cursor, sizeof(float));
+                value_out += sizeof(float);
+                cursor += sizeof(float);
+                break;
+            case ArgType::kDouble:
+                std::memcpy(value_out, cursor, sizeof(double));
+                value_out += sizeof(double);
+                cursor += sizeof(double);
+                break;
+            case ArgType::kPointer:
+                value_out = EncodeVarint(
+                    value_out, reinterpret_cast<uintptr_t>(ReadValue<const void *>(cursor)));
+                break;
+            case ArgType::kString: {
+                auto size = ReadValue<uint32_t>(cursor);
+                value_out = EncodeVarint(value_out, size);
+                std::memcpy(value_out, cursor, size);
+                value_out += size;
+                cursor += size;
+                break;
+            }
+            default:
+                --type_out;
+                cursor = end;  // 损坏的记录，丢弃剩余参数
+                break;
+        }
+    }
+
+    types.resize(static_cast<size_t>(type_out - types.data()));
+    out.resize(static_cast<size_t>(value_out - out.data()));
+}
+
+uint64_t WallNs(const LogEvent &event) {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                     event.timestamp().time_since_epoch())
+                                     .count());
+}
+
+}  // namespace
+
+size_t BinaryFileAppender::SiteKeyHash::operator()(const SiteKey &key) const {
+    // 格式串、文件名都是字面量地址，组合几个指针即可
+    size_t hash = std::hash<const void *>()(key.format);
+    hash = hash * 31 + std::hash<const void *>()(key.file);
+    hash = hash * 31 + std::hash<const void *>()(key.logger);
+    return hash * 31 + key.line;
+}
+
+BinaryFileAppender::BinaryFileAppender(const std::string &name)
+    : FileAppender(AppenderType::BINARY, name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    StartLocked();
+}
+
+void BinaryFileAppender::Log(const std::shared_ptr<LogEvent> event, Level level) {
+    if (!level.cmp(event->level())) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (fd_ < 0) {
+        fmt::println("File is not opened! Please open file...");
+        return;
+    }
+
+    // 调用点由参数类型确定，而它的定义要写在事件之前：参数值先单独编码
+    values_.clear();
+    types_.clear();
+    const ArgRecord &args = event->record();
+    if (args.empty()) {
+        auto message = event->message();
+        PutString(values_, message.data(), message.size());
+    } else {
+        EncodeArgs(args.data(), types_, values_);
+    }
+
+    record_.clear();
+    uint32_t site = SiteLocked(*event, fmt::string_view(types_.data(), types_.size()));
+    uint32_t thread = ThreadLocked(event->thread_info());
+
+    uint64_t wall = WallNs(*event);
+    char head[1 + 3 * 10];
+    char *out = head;
+    *out++ = static_cast<char>(BinaryRecord::kEvent);
+    out = EncodeVarint(out, site);
+    out = EncodeVarint(out, thread);
+    out = EncodeVarint(out, ZigZag(static_cast<int64_t>(wall - last_wall_)));
+    last_wall_ = wall;
+    record_.append(head, out);
+    record_.append(values_.data(), values_.data() + values_.size());
+
+    AppendLocked(event, fmt::string_view(record_.data(), record_.size()));
+}
+
+void BinaryFileAppender::ReOpen() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    CloseLocked();
+    Open();
+    StartLocked();
+}
+
+void BinaryFileAppender::StartLocked() {
+    struct stat st;
+    if (::fstat(fd_, &st) != 0) {
+        throw std::runtime_error(
+            fmt::format("Stat file '{}' failed, error: {}", file_name_, std::strerror(errno)));
+    }
+
+    if (st.st_size == 0) {
+        buffer_.append(kBinaryLogMagic, kBinaryLogMagic + sizeof(kBinaryLogMagic));
+    } else {
+        // 续写已有文件前确认它确实是二进制日志，不往文本日志里混入二进制数据
+        char magic[sizeof(kBinaryLogMagic)] = {};
+        int fd = ::open(file_name_.c_str(), O_RDONLY | O_CLOEXEC);
+        bool ok = fd >= 0 && ::pread(fd, magic, sizeof(magic), 0) == sizeof(magic) &&
+                  std::memcmp(magic, kBinaryLogMagic, sizeof(magic)) == 0;
+        if (fd >= 0) {
+            ::close(fd);
+        }
+        if (!ok) {
+            throw std::runtime_error(fmt::format("File '{}' is not a binary log", file_name_));
+        }
+    }
+
+    // 新的一段：编号从头开始，解码器遇到 kHeader 时清空字典
+    site_index_.clear();
+    sites_.clear();
+    last_site_ = -1;
+    threads_.clear();
+    next_thread_ = 0;
+
+    Clock::Stamp stamp = Clock::Now();
+    last_wall_ = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                           Clock::ToTimePoint(stamp).time_since_epoch())
+                                           .count());
+    record_.clear();
+    PutByte(record_, static_cast<uint8_t>(BinaryRecord::kHeader));
+    PutVarint(record_, kBinaryLogVersion);
+    PutVarint(record_, last_wall_);
+    PutVarint(record_, Clock::ElapsedNs(stamp));
+    buffer_.append(record_.data(), record_.data() + record_.size());
+}
+
+uint32_t BinaryFileAppender::SiteLocked(const LogEvent &event, fmt::string_view types) {
+    const ArgRecord &args = event.record();
+    const std::shared_ptr<Logger> &logger = event.logger();
+    SiteKey key{args.empty() ? nullptr : args.format().data(), event.file(), event.function(),
+                logger.get(), event.line(), event.level().level()};
+
+    auto same_types = [&](const Site &site) {
+        return site.types.size() == types.size() &&
+               std::memcmp(site.types.data(), types.data(), types.size()) == 0;
+    };
+
+    // 日志多在循环里连续产生，先看是不是上一条的调用点，省掉一次哈希查找
+    int index = -1;
+    int last = -1;
+    if (last_site_ >= 0 && key == last_key_ && same_types(sites_[last_site_])) {
+        index = last_site_;
+    } else {
+        auto it = site_index_.find(key);
+        index = it == site_index_.end() ? -1 : it->second;
+        while (index >= 0 && !same_types(sites_[index])) {
+            last = index;
+            index = sites_[index].next;
+        }
+    }
+
+    if (index >= 0 && (!logger || !sites_[index].logger.expired())) {
+        last_key_ = key;
+        last_site_ = index;
+        return sites_[index].id;
+    }
+
+    if (index < 0) {
+        index = static_cast<int>(sites_.size());
+        Site site;
+        site.id = static_cast<uint32_t>(index);
+        site.types.assign(types.data(), types.size());
+        sites_.push_back(std::move(site));
+        if (last >= 0) {
+            sites_[last].next = index;
+        } else {
+            site_index_.emplace(key, index);
+        }
+    }
+    // 新的调用点，或者旧日志器已销毁、地址被新日志器复用：重新定义该编号
+    Site &site = sites_[index];
+    site.logger = logger;
+
+    PutByte(record_, static_cast<uint8_t>(BinaryRecord::kSite));
+    PutVarint(record_, site.id);
+    PutByte(record_, static_cast<uint8_t>(key.level));
+    PutString(record_, logger ? logger->name().c_str() : "");
+    PutString(record_, event.file());
+    PutVarint(record_, event.line());
+    PutString(record_, event.function());
+    PutByte(record_, args.empty() ? kBinarySitePreformatted : 0);
+    PutString(record_, args.format().data(), args.format().size());
+    PutString(record_, types.data(), types.size());
+    return site.id;
+}
+
+uint32_t BinaryFileAppender::ThreadLocked(const ThreadInfo &thread) {
+    auto it = threads_.find(thread.tid());
+    if (it != threads_.end() && it->second.pthread_id == thread.pthread_id() &&
+        std::strncmp(it->second.name, thread.name(), sizeof(it->second.name)) == 0) {
+        return it->second.id;
+    }
+
+    // 第一次出现的线程，或者线程号被复用、线程改了名：沿用原编号重新定义
+    if (it == threads_.end()) {
+        it = threads_.emplace(thread.tid(), Thread()).first;
+        it->second.id = next_thread_++;
+    }
+    Thread &entry = it->second;
+    entry.pthread_id = thread.pthread_id();
+    std::memcpy(entry.name, thread.name(), sizeof(entry.name));  // ThreadInfo 的名字同为 16 字节
+
+    PutByte(record_, static_cast<uint8_t>(BinaryRecord::kThread));
+    PutVarint(record_, entry.id);
+    PutVarint(record_, static_cast<uint32_t>(thread.tid()));
+    PutVarint(record_, static_cast<uint64_t>(thread.pthread_id()));
+    PutString(record_, entry.name);
+    return entry.id;
+}
+
+}  // namespace log
+}  // namespace rein
@@ -0,0 +1,335 @@
+#include "log/binary_reader.h"
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include "log/binary_appender.h"
+#include "log/clock.h"
+#include "log/log_manager.h"
+#include "log/logger.h"
+
+namespace rein {
+namespace log {
+
+namespace {
+
+constexpr size_t kReadSize = 1024 * 1024;
+constexpr const char* kPreformattedFormat = "{}";
+
+int64_t UnZigZag(uint64_t value) {
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+template <typename T>
+void PutValue(fmt::memory_buffer& out, ArgType type, T value) {
+    out.push_back(static_cast<char>(type));
+    const char* bytes = reinterpret_cast<const char*>(&value);
+    out.append(bytes, bytes + sizeof(T));
+}
+
+std::shared_ptr<Logger> FindLogger(const std::string& name) {
+    auto& manager = LogManager::instance();
+    if (name == kRootLoggerName) {
+        return manager.root_logger();
+    }
+    auto logger = manager.logger(name);
+    if (!logger) {
+        manager.AddLogger(name);
+        logger = manager.logger(name);
+    }
+    return logger;
+}
+
+}  // namespace
+
+// 在一段内存上顺序解析，越界时置 ok = false，之后的读取都返回零值
+struct BinaryLogReader::Cursor {
+    const char* pos;
+    const char* end;
+    bool ok = true;
+
+    Cursor(const char* begin, const char* limit)
+        : pos(begin),
+          end(limit) {}
+
+    const char* Bytes(size_t size) {
+        if (!ok || static_cast<size_t>(end - pos) < size) {
+            ok = false;
+            return nullptr;
+        }
+        const char* data = pos;
+        pos += size;
+        return data;
+    }
+
+    uint8_t Byte() {
+        const char* data = Bytes(1);
+        return data ? static_cast<uint8_t>(*data) : 0;
+    }
+
+    uint64_t Varint() {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            uint8_t byte = Byte();
+            value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) {
+                return value;
+            }
+        }
+        ok = false;
+        return 0;
+    }
+
+    fmt::string_view String() {
+        size_t size = static_cast<size_t>(Varint());
+        const char* data = Bytes(size);
+        return data ? fmt::string_view(data, size) : fmt::string_view();
+    }
+};
+
+BinaryLogReader::BinaryLogReader(const std::string& file)
+    : file_name_(file),
+      data_(kReadSize) {
+    file_ = std::fopen(file.c_str(), "rb");
+    if (!file_) {
+        throw std::runtime_error(
+            fmt::format("Could not open file '{}', error: {}", file, std::strerror(errno)));
+    }
+
+    while (end_ < sizeof(kBinaryLogMagic) && Fill()) {
+    }
+    if (end_ < sizeof(kBinaryLogMagic) ||
+        std::memcmp(data_.data(), kBinaryLogMagic, sizeof(kBinaryLogMagic)) != 0) {
+        std::fclose(file_);
+        throw std::runtime_error(fmt::format("File '{}' is not a binary log", file));
+    }
+    pos_ = sizeof(kBinaryLogMagic);
+}
+
+BinaryLogReader::~BinaryLogReader() { std::fclose(file_); }
+
+std::shared_ptr<LogEvent> BinaryLogReader::Next() {
+    for (;;) {
+        std::shared_ptr<LogEvent> event;
+        if (pos_ < end_ && Parse(event)) {
+            if (event) {
+                return event;
+            }
+            continue;  // 字典记录，继续读下一条
+        }
+        if (!Fill()) {
+            truncated_ = pos_ < end_;
+            return nullptr;
+        }
+    }
+}
+
+bool BinaryLogReader::Fill() {
+    if (eof_) {
+        return false;
+    }
+
+    // 未解析完的半条记录移到开头；一条记录比整个缓冲区还大时扩容
+    std::memmove(data_.data(), data_.data() + pos_, end_ - pos_);
+    end_ -= pos_;
+    pos_ = 0;
+    if (end_ == data_.size()) {
+        data_.resize(data_.size() * 2);
+    }
+
+    size_t n = std::fread(data_.data() + end_, 1, data_.size() - end_, file_);
+    if (n == 0) {
+        eof_ = true;
+        return false;
+    }
+    end_ += n;
+    return true;
+}
+
+bool BinaryLogReader::Parse(std::shared_ptr<LogEvent>& event) {
+    // 每种记录都先完整解析到局部变量，确认数据足够后才修改状态
+    Cursor cursor(data_.data() + pos_, data_.data() + end_);
+    auto type = static_cast<BinaryRecord>(cursor.Byte());
+    switch (type) {
+        case BinaryRecord::kHeader: {
+            uint64_t version = cursor.Varint();
+            uint64_t wall = cursor.Varint();
+            uint64_t elapsed = cursor.Varint();
+            if (!cursor.ok) {
+                return false;
+            }
+            if (version > kBinaryLogVersion) {
+                throw std::runtime_error(fmt::format(
+                    "File '{}' uses binary log version {}, supported up to {}", file_name_,
+                    version, kBinaryLogVersion));
+            }
+            sites_.clear();
+            threads_.clear();
+            base_wall_ = wall;
+            base_elapsed_ = elapsed;
+            last_wall_ = wall;
+            break;
+        }
+        case BinaryRecord::kSite:
+            ParseSite(cursor);
+            break;
+        case BinaryRecord::kThread:
+            ParseThread(cursor);
+            break;
+        case BinaryRecord::kEvent:
+            event = ParseEvent(cursor);
+            break;
+        default:
+            throw std::runtime_error(fmt::format("File '{}' is corrupted: unknown record type {}",
+                                                 file_name_, static_cast<int>(type)));
+    }
+
+    if (!cursor.ok) {
+        return false;
+    }
+    pos_ = static_cast<size_t>(cursor.pos - data_.data());
+    return true;
+}
+
+void BinaryLogReader::ParseSite(Cursor& cursor) {
+    uint64_t id = cursor.Varint();
+    auto level = static_cast<LevelType>(cursor.Byte());
+    fmt::string_view logger = cursor.String();
+    fmt::string_view file = cursor.String();
+    uint64_t line = cursor.Varint();
+    fmt::string_view function = cursor.String();
+    uint8_t flags = cursor.Byte();
+    fmt::string_view format = cursor.String();
+    fmt::string_view types = cursor.String();
+    if (!cursor.ok) {
+        return;
+    }
+
+    // 编号按出现顺序分配，只会重新定义已有的或者紧接着的下一个
+    if (id > sites_.size()) {
+        throw std::runtime_error(fmt::format("File '{}' is corrupted: site {} out of order",
+                                             file_name_, id));
+    }
+    if (id == sites_.size()) {
+        sites_.emplace_back();
+    }
+    Site& site = sites_[id];
+    site.defined = true;
+    site.level = Level(level);
+    site.logger = FindLogger(std::string(logger.data(), logger.size()));
+    site.file.assign(file.data(), file.size());
+    site.line = static_cast<uint32_t>(line);
+    site.function.assign(function.data(), function.size());
+    site.flags = flags;
+    site.format.assign(format.data(), format.size());
+    site.types.assign(types.data(), types.size());
+}
+
+void BinaryLogReader::ParseThread(Cursor& cursor) {
+    uint64_t id = cursor.Varint();
+    uint64_t tid = cursor.Varint();
+    uint64_t pthread_id = cursor.Varint();
+    fmt::string_view name = cursor.String();
+    if (!cursor.ok) {
+        return;
+    }
+
+    if (id > threads_.size()) {
+        throw std::runtime_error(fmt::format("File '{}' is corrupted: thread {} out of order",
+                                             file_name_, id));
+    }
+    if (id == threads_.size()) {
+        threads_.emplace_back();
+    }
+    threads_[id] = ThreadInfo::Make(static_cast<pid_t>(tid), static_cast<pthread_t>(pthread_id),
+                                    std::string(name.data(), name.size()).c_str());
+}
+
+std::shared_ptr<LogEvent> BinaryLogReader::ParseEvent(Cursor& cursor) {
+    uint64_t site_id = cursor.Varint();
+    uint64_t thread_id = cursor.Varint();
+    int64_t delta = UnZigZag(cursor.Varint());
+    if (!cursor.ok) {
+        return nullptr;
+    }
+    if (site_id >= sites_.size() || !sites_[site_id].defined || thread_id >= threads_.size() ||
+        !threads_[thread_id]) {
+        throw std::runtime_error(
+            fmt::format("File '{}' is corrupted: undefined site {} or thread {}", file_name_,
+                        site_id, thread_id));
+    }
+    const Site& site = sites_[site_id];
+
+    // 按调用点记录的类型把参数还原为 ArgRecord 的定长编码
+    args_.clear();
+    if (site.flags & kBinarySitePreformatted) {
+        fmt::string_view message = cursor.String();
+        PutValue(args_, ArgType::kString, static_cast<uint32_t>(message.size()));
+        args_.append(message.data(), message.data() + message.size());
+    } else {
+        for (char tag : site.types) {
+            auto type = static_cast<ArgType>(tag);
+            switch (type) {
+                case ArgType::kBool:
+                    PutValue(args_, type, cursor.Byte() != 0);
+                    break;
+                case ArgType::kChar:
+                    PutValue(args_, type, static_cast<char>(cursor.Byte()));
+                    break;
+                case ArgType::kInt:
+                    PutValue(args_, type, UnZigZag(cursor.Varint()));
+                    break;
+                case ArgType::kUint:
+                    PutValue(args_, type, cursor.Varint());
+                    break;
+                case ArgType::kFloat:
+                case ArgType::kDouble: {
+                    size_t size = type == ArgType::kFloat ? sizeof(float) : sizeof(double);
+                    const char* bytes = cursor.Bytes(size);
+                    if (bytes) {
+                        args_.push_back(static_cast<char>(type));
+                        args_.append(bytes, bytes + size);
+                    }
+                    break;
+                }
+                case ArgType::kPointer:
+                    PutValue(args_, type,
+                             reinterpret_cast<const void*>(static_cast<uintptr_t>(cursor.Varint())));
+                    break;
+                case ArgType::kString: {
+                    fmt::string_view value = cursor.String();
+                    PutValue(args_, type, static_cast<uint32_t>(value.size()));
+                    args_.append(value.data(), value.data() + value.size());
+                    break;
+                }
+                default:
+                    throw std::runtime_error(fmt::format(
+                        "File '{}' is corrupted: unknown argument type {}", file_name_,
+                        static_cast<int>(tag)));
+            }
+        }
+    }
+    if (!cursor.ok) {
+        return nullptr;
+    }
+
+    uint64_t wall = last_wall_ + static_cast<uint64_t>(delta);
+    last_wall_ = wall;
+    int64_t since_header = static_cast<int64_t>(wall - base_wall_);
+    uint64_t elapsed = since_header < 0 && static_cast<uint64_t>(-since_header) > base_elapsed_
+                           ? 0
+                           : base_elapsed_ + static_cast<uint64_t>(since_header);
+
+    auto event = std::make_shared<LogEvent>(site.level, site.file.c_str(), site.line,
+                                            site.function.c_str(), Clock::Restore(wall, elapsed),
+                                            threads_[thread_id], site.logger);
+    fmt::string_view format = (site.flags & kBinarySitePreformatted)
+                                  ? fmt::string_view(kPreformattedFormat)
+                                  : fmt::string_view(site.format);
+    event->Assign(format, fmt::string_view(args_.data(), args_.size()));
+    return event;
+}
+
+}  // namespace log
+}  // namespace rein
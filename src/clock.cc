@@ -0,0 +1,235 @@
+#include "log/clock.h"
+
+#include <mutex>
+#include <thread>
+
+#if REIN_LOG_HAS_TSC
+    #include <cpuid.h>
+#endif
+
+namespace rein {
+namespace log {
+
+namespace {
+
+// TSC 与墙上时间/单调时钟的对应关系。换算线程随时在读，重新对齐时用序号（seqlock）保护，
+// 读到奇数或前后序号不一致说明正在更新，重读即可；字段都是原子量，没有数据竞争
+struct TscCalibration {
+    std::atomic<uint32_t> seq{0};
+    std::atomic<uint64_t> tsc{0};          // 对齐点的 TSC 计数
+    std::atomic<uint64_t> wall{0};         // 对齐点的 Unix 纳秒
+    std::atomic<uint64_t> mono{0};         // 对齐点的单调时钟纳秒
+    std::atomic<double> ns_per_tick{0};
+    std::atomic<uint64_t> next_tsc{0};     // 换算的计数超过它时重新对齐
+};
+
+// seqlock 读出的一份一致的快照
+struct TscAnchor {
+    uint64_t tsc;
+    uint64_t wall;
+    uint64_t mono;
+    double ns_per_tick;
+    uint64_t next_tsc;
+};
+
+constexpr auto kTscCalibrationTime = std::chrono::milliseconds(10);
+
+// 进程启动基准，elapse 相对它计算
+const uint64_t g_start_mono = Clock::Read(CLOCK_MONOTONIC);
+
+TscCalibration g_tsc;
+std::atomic<bool> g_tsc_ready(false);
+std::mutex g_calibrate_mutex;
+// 第一次校准的采样点，之后重新对齐时以它为起点计算频率，基线越长频率越准；受 g_calibrate_mutex 保护
+uint64_t g_first_tsc = 0;
+uint64_t g_first_mono = 0;
+
+#if REIN_LOG_HAS_TSC
+// CPUID.80000007H:EDX[8]：TSC 频率恒定且各核同步，才能用作时间源
+bool HasInvariantTsc() {
+    unsigned int eax, ebx, ecx, edx;
+    if (!__get_cpuid(0x80000000, &eax, &ebx, &ecx, &edx) || eax < 0x80000007) {
+        return false;
+    }
+    __get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx);
+    return (edx & (1u << 8)) != 0;
+}
+
+// 取一个 TSC 与时钟尽量贴近的采样点：选取读时钟前后 TSC 间隔最小的一次
+void Sample(uint64_t& tsc, uint64_t& wall, uint64_t& mono) {
+    uint64_t best = ~0ull;
+    for (int i = 0; i < 8; ++i) {
+        uint64_t begin = __rdtsc();
+        uint64_t w = Clock::Read(CLOCK_REALTIME);
+        uint64_t m = Clock::Read(CLOCK_MONOTONIC);
+        uint64_t end = __rdtsc();
+        if (end - begin < best) {
+            best = end - begin;
+            tsc = begin + (end - begin) / 2;
+            wall = w;
+            mono = m;
+        }
+    }
+}
+
+// 发布新的对齐点；调用方持有 g_calibrate_mutex
+void Publish(uint64_t tsc, uint64_t wall, uint64_t mono, double ns_per_tick) {
+    const uint32_t seq = g_tsc.seq.load(std::memory_order_relaxed);
+    g_tsc.seq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    g_tsc.tsc.store(tsc, std::memory_order_relaxed);
+    g_tsc.wall.store(wall, std::memory_order_relaxed);
+    g_tsc.mono.store(mono, std::memory_order_relaxed);
+    g_tsc.ns_per_tick.store(ns_per_tick, std::memory_order_relaxed);
+    g_tsc.next_tsc.store(tsc + static_cast<uint64_t>(kClockReanchorNs / ns_per_tick),
+                         std::memory_order_relaxed);
+    g_tsc.seq.store(seq + 2, std::memory_order_release);
+}
+
+TscAnchor LoadAnchor() {
+    TscAnchor anchor;
+    for (;;) {
+        const uint32_t seq = g_tsc.seq.load(std::memory_order_acquire);
+        anchor.tsc = g_tsc.tsc.load(std::memory_order_relaxed);
+        anchor.wall = g_tsc.wall.load(std::memory_order_relaxed);
+        anchor.mono = g_tsc.mono.load(std::memory_order_relaxed);
+        anchor.ns_per_tick = g_tsc.ns_per_tick.load(std::memory_order_relaxed);
+        anchor.next_tsc = g_tsc.next_tsc.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if ((seq & 1) == 0 && g_tsc.seq.load(std::memory_order_relaxed) == seq) {
+            return anchor;
+        }
+    }
+}
+
+bool Calibrate() {
+    std::lock_guard<std::mutex> lock(g_calibrate_mutex);
+    if (g_tsc_ready.load(std::memory_order_acquire)) {
+        return true;
+    }
+
+    uint64_t tsc0 = 0, wall0 = 0, mono0 = 0;
+    uint64_t tsc1 = 0, wall1 = 0, mono1 = 0;
+    Sample(tsc0, wall0, mono0);
+    std::this_thread::sleep_for(kTscCalibrationTime);
+    Sample(tsc1, wall1, mono1);
+    if (tsc1 <= tsc0 || mono1 <= mono0) {
+        return false;
+    }
+
+    g_first_tsc = tsc0;
+    g_first_mono = mono0;
+    Publish(tsc1, wall1, mono1,
+            static_cast<double>(mono1 - mono0) / static_cast<double>(tsc1 - tsc0));
+    g_tsc_ready.store(true, std::memory_order_release);
+    return true;
+}
+
+/*
+  重新对齐：以当前时刻为新的对齐点，墙上时间重新取自 CLOCK_REALTIME（跟上 NTP 的步进与微调），
+  频率按第一次校准以来的整段单调时间重新计算。
+  由换算线程在计数越过 next_tsc 时触发，每秒至多一次；别的线程正在对齐时直接沿用旧的对齐点。
+*/
+void ReanchorTsc(uint64_t tsc) {
+    std::unique_lock<std::mutex> lock(g_calibrate_mutex, std::try_to_lock);
+    if (!lock.owns_lock() || tsc < g_tsc.next_tsc.load(std::memory_order_relaxed)) {
+        return;
+    }
+    uint64_t now_tsc = 0, wall = 0, mono = 0;
+    Sample(now_tsc, wall, mono);
+    double ns_per_tick = g_tsc.ns_per_tick.load(std::memory_order_relaxed);
+    if (now_tsc > g_first_tsc && mono > g_first_mono) {
+        ns_per_tick = static_cast<double>(mono - g_first_mono) /
+                      static_cast<double>(now_tsc - g_first_tsc);
+    }
+    Publish(now_tsc, wall, mono, ns_per_tick);
+}
+
+// 取 tsc 换算用的对齐点，过期时先重新对齐
+TscAnchor AnchorFor(uint64_t tsc) {
+    TscAnchor anchor = LoadAnchor();
+    if (tsc >= anchor.next_tsc) {
+        ReanchorTsc(tsc);
+        anchor = LoadAnchor();
+    }
+    return anchor;
+}
+
+int64_t TicksToNs(const TscAnchor& anchor, uint64_t tsc) {
+    return static_cast<int64_t>(static_cast<double>(static_cast<int64_t>(tsc - anchor.tsc)) *
+                                anchor.ns_per_tick);
+}
+#endif
+
+}  // namespace
+
+std::atomic<ClockType> Clock::type_(ClockType::kRealtime);
+std::atomic<uint64_t> Clock::wall_offset_(0);
+std::atomic<uint64_t> Clock::offset_expiry_(0);
+
+void Clock::Reanchor(uint64_t mono) {
+    // 取前后两次单调时间间隔最小的一次采样，偏移误差在几十纳秒以内。
+    // 多个线程同时过期时各自测一遍，结果一样，不值得为每秒一次的操作加锁
+    uint64_t best = ~0ull;
+    uint64_t offset = 0;
+    for (int i = 0; i < 4; ++i) {
+        uint64_t begin = Read(CLOCK_MONOTONIC);
+        uint64_t wall = Read(CLOCK_REALTIME);
+        uint64_t end = Read(CLOCK_MONOTONIC);
+        if (end - begin < best) {
+            best = end - begin;
+            offset = wall - (begin + (end - begin) / 2);
+        }
+    }
+    wall_offset_.store(offset, std::memory_order_relaxed);
+    offset_expiry_.store(mono + kClockReanchorNs, std::memory_order_release);
+}
+
+ClockType Clock::Set(ClockType type) {
+    if (type == ClockType::kTsc) {
+#if REIN_LOG_HAS_TSC
+        if (!HasInvariantTsc() || !Calibrate()) {
+            type = ClockType::kRealtime;
+        }
+#else
+        type = ClockType::kRealtime;
+#endif
+    }
+    type_.store(type, std::memory_order_relaxed);
+    return type;
+}
+
+Clock::Stamp Clock::Restore(uint64_t wall_ns, uint64_t elapsed_ns) {
+    Stamp stamp;
+    stamp.type = ClockType::kRealtime;
+    stamp.wall = wall_ns;
+    stamp.mono = g_start_mono + elapsed_ns;
+    return stamp;
+}
+
+std::chrono::system_clock::time_point Clock::ToTimePoint(const Stamp& stamp) {
+    uint64_t wall = stamp.wall;
+#if REIN_LOG_HAS_TSC
+    if (stamp.type == ClockType::kTsc) {
+        const TscAnchor anchor = AnchorFor(stamp.wall);
+        wall = anchor.wall + TicksToNs(anchor, stamp.wall);
+    }
+#endif
+    return std::chrono::system_clock::time_point(
+        std::chrono::duration_cast<std::chrono::system_clock::duration>(
+            std::chrono::nanoseconds(wall)));
+}
+
+uint64_t Clock::ElapsedNs(const Stamp& stamp) {
+    uint64_t mono = stamp.mono;
+#if REIN_LOG_HAS_TSC
+    if (stamp.type == ClockType::kTsc) {
+        const TscAnchor anchor = AnchorFor(stamp.wall);
+        mono = anchor.mono + TicksToNs(anchor, stamp.wall);
+    }
+#endif
+    return mono > g_start_mono ? mono - g_start_mono : 0;
+}
+
+}  // namespace log
+}  // namespace rein
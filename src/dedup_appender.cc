@@ -0,0 +1,140 @@
+#include "log/dedup_appender.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "log/event.h"
+#include "log/flush_scheduler.h"
+#include "log/object_pool.hpp"
+#include "log/util.hpp"
+
+namespace rein {
+namespace log {
+
+DedupAppender::DedupAppender(std::shared_ptr<Appender> target,
+                             size_t window,
+                             std::chrono::milliseconds summary_interval)
+    : Appender(AppenderType::DEDUP, target ? target->name() : ""),
+      target_(std::move(target)),
+      entries_(std::max<size_t>(window, 1)),
+      summary_interval_(summary_interval) {
+    if (!target_) {
+        throw std::invalid_argument("DedupAppender needs a target appender");
+    }
+    if (summary_interval_.count() > 0) {
+        FlushScheduler::instance().Register(this, summary_interval_, [this]() { Summarize(); });
+    }
+}
+
+DedupAppender::~DedupAppender() {
+    if (summary_interval_.count() > 0) {
+        FlushScheduler::instance().Unregister(this);
+    }
+    // 退出时把尚未汇总的重复写出去，不让它们无声地丢失
+    std::lock_guard<std::mutex> lock(mutex_);
+    SummarizeAllLocked();
+    target_->Flush();
+}
+
+uint64_t DedupAppender::Hash(const LogEvent& event) {
+    // 调用点由文件名指针与行号确定，与级别一起作为消息散列的种子
+    const uint64_t site = reinterpret_cast<uintptr_t>(event.file()) ^
+                          (static_cast<uint64_t>(event.line()) << 32) ^
+                          static_cast<uint64_t>(event.level().level());
+    fmt::string_view message = event.message();
+    return util::Hash64(message.data(), message.size(), site);
+}
+
+bool DedupAppender::SameMessage(const LogEvent& lhs, const LogEvent& rhs) {
+    fmt::string_view a = lhs.message();
+    fmt::string_view b = rhs.message();
+    return lhs.line() == rhs.line() && lhs.level().level() == rhs.level().level() &&
+           lhs.file() == rhs.file() && a.size() == b.size() &&
+           std::equal(a.data(), a.data() + a.size(), b.data());
+}
+
+void DedupAppender::Log(const std::shared_ptr<LogEvent> event, Level level) {
+    if (!level.cmp(event->level())) {
+        return;
+    }
+
+    const uint64_t hash = Hash(*event);
+    const uint64_t now = event->elapse_ns();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++tick_;
+    Entry* victim = &entries_[0];
+    for (Entry& entry : entries_) {
+        // 散列相同时再比较一次正文，碰撞不会吞掉不同的消息
+        if (entry.event && entry.hash == hash && SameMessage(*entry.event, *event)) {
+            ++entry.repeats;
+            entry.last_ns = now;
+            entry.used = tick_;
+            suppressed_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        if (entry.used < victim->used) {
+            victim = &entry;
+        }
+    }
+
+    // 新消息：先汇总被挤出的那条，保证汇总行出现在新消息之前
+    if (victim->repeats > 0) {
+        SummarizeLocked(*victim);
+    }
+    victim->hash = hash;
+    victim->event = event;
+    victim->repeats = 0;
+    victim->first_ns = now;
+    victim->last_ns = now;
+    victim->used = tick_;
+    victim->written = ++written_;
+
+    target_->Log(event, target_->level());
+}
+
+void DedupAppender::SummarizeLocked(Entry& entry) {
+    const LogEvent& original = *entry.event;
+    const double seconds = static_cast<double>(entry.last_ns - entry.first_ns) / 1e9;
+    std::string text =
+        entry.written == written_
+            ? fmt::format("last message repeated {} times in {:.1f}s", entry.repeats, seconds)
+            : fmt::format("message repeated {} times in {:.1f}s: {}", entry.repeats, seconds,
+                          original.message());
+
+    auto summary = std::allocate_shared<LogEvent>(
+        PoolAllocator<LogEvent>(), original.level(), original.file(), original.line(),
+        original.function(), fmt::string_view(text), original.logger());
+    entry.repeats = 0;
+    entry.first_ns = entry.last_ns;
+    ++written_;
+    target_->Log(summary, target_->level());
+}
+
+void DedupAppender::SummarizeAllLocked() {
+    // 按最近出现的先后写出，保持与原消息相近的顺序
+    std::vector<Entry*> pending;
+    for (Entry& entry : entries_) {
+        if (entry.repeats > 0) {
+            pending.push_back(&entry);
+        }
+    }
+    std::sort(pending.begin(), pending.end(),
+              [](const Entry* lhs, const Entry* rhs) { return lhs->used < rhs->used; });
+    for (Entry* entry : pending) {
+        SummarizeLocked(*entry);
+    }
+}
+
+void DedupAppender::Summarize() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    SummarizeAllLocked();
+}
+
+void DedupAppender::Flush() {
+    Summarize();
+    target_->Flush();
+}
+
+}  // namespace log
+}  // namespace rein
@@ -0,0 +1,288 @@
+#include "log/durable_appender.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <vector>
+
+#include "log/event.h"
+#include "log/layout.h"
+
+namespace rein {
+namespace log {
+
+DurableFileAppender::DurableFileAppender(const std::string& name, SyncMode mode,
+                                         size_t preallocate_size)
+    : FileAppender(AppenderType::DURABLE, name),
+      mode_(mode),
+      preallocate_size_(std::max<size_t>(preallocate_size, 1)) {
+    AttachLocked();
+    synced_ = written_;  // 打开前的内容不属于本次的任何凭据
+}
+
+DurableFileAppender::~DurableFileAppender() {
+    Sync();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    FlushLocked();
+    TruncateLocked();
+}
+
+void DurableFileAppender::ReOpen() {
+    // 作为一轮提交执行：等正在进行的 fdatasync 结束，并阻止新的一轮开始，
+    // 不会有线程拿着即将关闭的 fd 同步
+    std::unique_lock<std::mutex> sync_lock(sync_mutex_);
+    sync_cv_.wait(sync_lock, [this] { return !syncing_; });
+    syncing_ = true;
+    sync_lock.unlock();
+
+    int ret = -1;
+    int err = EBADF;
+    uint64_t target = 0;
+    try {
+        std::lock_guard<std::mutex> lock(mutex_);
+        // 旧文件：写出缓冲、落盘、去掉预分配的尾部后关闭
+        FlushLocked();
+        target = base_ + written_;
+        if (fd_ >= 0) {
+            ret = ::fdatasync(fd_);
+            err = errno;
+        }
+        TruncateLocked();
+        CloseLocked();
+
+        // 新文件（可能是被轮转后重新创建的，也可能是崩溃留下的）：从它的实际末尾续写。
+        // 凭据接着旧文件的编号增长，之前拿到的凭据不会因为文件变短而失效
+        Open();
+        AttachLocked();
+        base_ = target - written_;
+    } catch (...) {
+        sync_lock.lock();
+        CompleteSyncLocked(ret, err, target);
+        throw;
+    }
+
+    sync_lock.lock();
+    CompleteSyncLocked(ret, err, target);
+}
+
+void DurableFileAppender::Log(const std::shared_ptr<LogEvent> event, Level level) {
+    if (!level.cmp(event->level())) {
+        return;
+    }
+
+    SyncTicket ticket;
+    SyncMode mode;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (fd_ < 0) {
+            fmt::println("File is not opened! Please open file...");
+            return;
+        }
+        record_.clear();
+        layout_->format(record_, event);
+        ticket = AppendRecordLocked(event, fmt::string_view(record_.data(), record_.size()));
+        mode = mode_;
+    }
+
+    if (mode == SyncMode::kBlocking) {
+        Wait(ticket);
+    }
+}
+
+void DurableFileAppender::Write(const std::shared_ptr<LogEvent>& event,
+                                fmt::string_view formatted) {
+    SyncTicket ticket;
+    SyncMode mode;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (fd_ < 0) {
+            fmt::println("File is not opened! Please open file...");
+            return;
+        }
+        ticket = AppendRecordLocked(event, formatted);
+        mode = mode_;
+    }
+
+    if (mode == SyncMode::kBlocking) {
+        Wait(ticket);
+    }
+}
+
+SyncTicket DurableFileAppender::Ticket() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return base_ + written_;
+}
+
+bool DurableFileAppender::Wait(SyncTicket ticket) {
+    std::unique_lock<std::mutex> lock(sync_mutex_);
+    for (;;) {
+        if (FailedLocked(ticket)) {
+            return false;
+        }
+        if (synced_ >= ticket) {
+            return true;
+        }
+        if (syncing_) {
+            sync_cv_.wait(lock);
+            continue;
+        }
+
+        // 成为本轮的提交者：一次 fdatasync 确认此刻之前写入的所有记录
+        syncing_ = true;
+        lock.unlock();
+
+        // 只在把缓冲交给内核时持有 mutex_，同步期间其他线程可以继续写入下一批
+        uint64_t target;
+        int fd;
+        {
+            std::lock_guard<std::mutex> guard(mutex_);
+            FlushLocked();
+            target = base_ + written_;
+            fd = fd_;
+        }
+        int ret = fd >= 0 ? ::fdatasync(fd) : -1;
+        int err = fd >= 0 ? errno : EBADF;
+
+        lock.lock();
+        CompleteSyncLocked(ret, err, target);
+    }
+}
+
+void DurableFileAppender::CompleteSyncLocked(int ret, int err, uint64_t target) {
+    syncing_ = false;
+    if (ret == 0) {
+        synced_ = std::max(synced_, target);
+    } else {
+        // 失败后页缓存的状态不可信，这段记录不再视为可确认
+        // 上次失败之后没有成功的同步时延长上一个区间，否则从已确认的位置开始新区间，
+        // 不吞掉两次失败之间已经被成功的 fdatasync 确认的记录
+        if (!failed_.empty() && failed_.back().second >= synced_) {
+            failed_.back().second = std::max(failed_.back().second, target);
+        } else if (target > synced_) {
+            failed_.emplace_back(synced_, target);
+        }
+        fmt::println(stderr, "Sync file '{}' failed, error: {}", file_name_, std::strerror(err));
+    }
+    sync_cv_.notify_all();
+}
+
+bool DurableFileAppender::IsDurable(SyncTicket ticket) const {
+    std::lock_guard<std::mutex> lock(sync_mutex_);
+    return synced_ >= ticket && !FailedLocked(ticket);
+}
+
+bool DurableFileAppender::FailedLocked(SyncTicket ticket) const {
+    // 区间按位置递增且互不重叠：找第一个 end >= ticket 的区间
+    auto it = std::lower_bound(
+        failed_.begin(), failed_.end(), ticket,
+        [](const std::pair<uint64_t, uint64_t>& range, SyncTicket value) {
+            return range.second < value;
+        });
+    return it != failed_.end() && ticket > it->first;
+}
+
+bool DurableFileAppender::Sync() { return Wait(Ticket()); }
+
+void DurableFileAppender::SetSyncMode(SyncMode mode) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    mode_ = mode;
+}
+
+SyncMode DurableFileAppender::sync_mode() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return mode_;
+}
+
+SyncTicket DurableFileAppender::AppendRecordLocked(const std::shared_ptr<LogEvent>& event,
+                                                   fmt::string_view formatted) {
+    PreallocateLocked(written_ + formatted.size());
+    AppendLocked(event, formatted);
+    written_ += formatted.size();
+    return base_ + written_;
+}
+
+void DurableFileAppender::PreallocateLocked(uint64_t end) {
+    if (!preallocate_ || end <= allocated_) {
+        return;
+    }
+
+    // 按块扩展文件（改变文件大小），之后的写入只覆盖已分配的空间
+    uint64_t target = (end + preallocate_size_ - 1) / preallocate_size_ * preallocate_size_;
+    if (::fallocate(fd_, 0, static_cast<off_t>(allocated_),
+                    static_cast<off_t>(target - allocated_)) != 0) {
+        if (errno == EOPNOTSUPP || errno == ENOSYS) {
+            preallocate_ = false;  // 文件系统不支持，退回随写入增长
+        } else {
+            fmt::println(stderr, "Preallocate file '{}' failed, error: {}", file_name_,
+                         std::strerror(errno));
+        }
+        return;
+    }
+    allocated_ = target;
+}
+
+void DurableFileAppender::AttachLocked() {
+    // 预分配后文件大小不再等于写入位置，去掉 O_APPEND 由自己定位
+    int flags = ::fcntl(fd_, F_GETFL);
+    if (flags >= 0) {
+        ::fcntl(fd_, F_SETFL, flags & ~O_APPEND);
+    }
+    preallocate_ = true;
+    Recover();
+    ::lseek(fd_, static_cast<off_t>(written_), SEEK_SET);
+}
+
+void DurableFileAppender::TruncateLocked() {
+    // 去掉没有用到的预分配空间
+    if (fd_ >= 0 && allocated_ > written_ &&
+        ::ftruncate(fd_, static_cast<off_t>(written_)) != 0) {
+        fmt::println(stderr, "Truncate file '{}' failed, error: {}", file_name_,
+                     std::strerror(errno));
+    }
+}
+
+void DurableFileAppender::Recover() {
+    struct stat st;
+    if (::fstat(fd_, &st) != 0) {
+        return;
+    }
+
+    // 崩溃时留下的预分配空间全是 NUL：从文件末尾向前找到最后一个非 NUL 字节。
+    // 写入用的 fd 是只写的，另开一个只读 fd 扫描
+    uint64_t end = static_cast<uint64_t>(st.st_size);
+    int fd = ::open(file_name_.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd >= 0) {
+        std::vector<char> block(64 * 1024);
+        while (end > 0) {
+            size_t n = static_cast<size_t>(std::min<uint64_t>(end, block.size()));
+            if (::pread(fd, block.data(), n, static_cast<off_t>(end - n)) !=
+                static_cast<ssize_t>(n)) {
+                break;
+            }
+            size_t i = n;
+            while (i > 0 && block[i - 1] == '\0') {
+                --i;
+            }
+            end -= n - i;
+            if (i > 0) {
+                break;
+            }
+        }
+        ::close(fd);
+    }
+
+    if (end < static_cast<uint64_t>(st.st_size) && ::ftruncate(fd_, static_cast<off_t>(end)) != 0) {
+        fmt::println(stderr, "Truncate file '{}' failed, error: {}", file_name_,
+                     std::strerror(errno));
+    }
+    written_ = end;
+    allocated_ = end;
+}
+
+}  // namespace log
+}  // namespace rein
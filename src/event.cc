@@ -3,23 +3,49 @@ rein::log::LogEvent::LogEvent(Level level,
                               const char* file,
                               uint32_t line,
                               const char* function,
-                              std::string message,
+                              fmt::string_view message,
+                              std::shared_ptr<Logger> logger)
+    : LogEvent(level, file, line, function, std::move(logger)) {
+    message_.append(message.data(), message.data() + message.size());
+    formatted_ = true;
+}
+
+rein::log::LogEvent::LogEvent(Level level,
+                              const char* file,
+                              uint32_t line,
+                              const char* function,
                               std::shared_ptr<Logger> logger)
     : level_(level),
-      file_(file),
       line_(line),
+      file_(file),
       function_(function),
-      message_(std::move(message)),
+      stamp_(Clock::Now()),
       logger_(std::move(logger)),
-      timestamp_(std::chrono::system_clock::now()),
-      pthread_id_(pthread_self()) {
-    // 计算程序启动到现在的毫秒数
-    static const auto start_time = std::chrono::system_clock::now();
-    elapse_ =
-        std::chrono::duration_cast<std::chrono::milliseconds>(timestamp_ - start_time).count();
+      thread_(ThreadInfo::Current()),
+      fiber_id_(0),
+      formatted_(true) {}
 
-    // 获取线程名（Linux 限制15字符）
-    char thread_name_buf[16] = {0};
-    pthread_getname_np(pthread_id_, thread_name_buf, sizeof(thread_name_buf));
-    thread_name_ = thread_name_buf;
-}
\ No newline at end of file
+fmt::string_view rein::log::LogEvent::message() const {
+    if (!formatted_) {
+        record_.Format(message_);
+        formatted_ = true;
+    }
+    return fmt::string_view(message_.data(), message_.size());
+}
+
+rein::log::LogEvent::LogEvent(Level level,
+                              const char* file,
+                              uint32_t line,
+                              const char* function,
+                              const Clock::Stamp& stamp,
+                              std::shared_ptr<const ThreadInfo> thread,
+                              std::shared_ptr<Logger> logger)
+    : level_(level),
+      line_(line),
+      file_(file),
+      function_(function),
+      stamp_(stamp),
+      logger_(std::move(logger)),
+      thread_(std::move(thread)),
+      fiber_id_(0),
+      formatted_(true) {}
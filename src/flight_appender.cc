@@ -0,0 +1,369 @@
+#include "log/flight_appender.h"
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <ctime>
+#include <stdexcept>
+
+#include "log/event.h"
+#include "log/logger.h"
+
+namespace rein {
+namespace log {
+
+namespace {
+
+constexpr size_t kMaxFlightRecorders = 16;  // 信号处理时能找到的飞行记录器个数上限
+// 写出时槽位副本与输出缓冲区都在栈上，信号处理函数可能运行在较小的 sigaltstack 上
+constexpr size_t kMaxFlightSlotSize = 1024;
+constexpr size_t kDumpBufferSize = 4096;
+constexpr int kFatalSignals[] = {SIGSEGV, SIGABRT, SIGBUS, SIGFPE, SIGILL};
+
+std::atomic<FlightRecorderAppender*> g_recorders[kMaxFlightRecorders];
+std::atomic<bool> g_handlers_installed(false);
+struct sigaction g_previous[NSIG];
+
+size_t RoundToPowerOfTwo(size_t value) {
+    size_t result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+long LocalUtcOffset() {
+    std::time_t now = std::time(nullptr);
+    std::tm tm;
+    return ::localtime_r(&now, &tm) ? tm.tm_gmtoff : 0;
+}
+
+// 以下都只写调用方的缓冲区，不分配内存、不加锁，可在信号处理函数中使用
+class DumpWriter {
+public:
+    explicit DumpWriter(int fd)
+        : fd_(fd) {}
+    ~DumpWriter() { Flush(); }
+
+    void Reserve(size_t size) {
+        if (kDumpBufferSize - size_ < size) {
+            Flush();
+        }
+    }
+
+    void Append(const char* data, size_t size) {
+        size = std::min(size, kDumpBufferSize - size_);
+        std::memcpy(buffer_ + size_, data, size);
+        size_ += size;
+    }
+    void Append(const char* text) { Append(text, std::strlen(text)); }
+    void Append(char c) { Append(&c, 1); }
+
+    // 十进制，不足 width 位时补 0
+    void AppendUint(uint64_t value, int width = 0) {
+        char digits[20];
+        int count = 0;
+        do {
+            digits[count++] = static_cast<char>('0' + value % 10);
+            value /= 10;
+        } while (value > 0);
+        for (int i = count; i < width; ++i) {
+            Append('0');
+        }
+        while (count > 0) {
+            Append(digits[--count]);
+        }
+    }
+
+    // YYYY-mm-dd HH:MM:SS.ffffff
+    void AppendTime(int64_t seconds, uint32_t micros) {
+        int64_t days = seconds / 86400;
+        int64_t rest = seconds % 86400;
+        if (rest < 0) {
+            rest += 86400;
+            --days;
+        }
+        // 公历日期换算（Howard Hinnant, civil_from_days）
+        days += 719468;
+        const int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+        const int64_t doe = days - era * 146097;
+        const int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+        const int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+        const int64_t mp = (5 * doy + 2) / 153;
+        const int64_t day = doy - (153 * mp + 2) / 5 + 1;
+        const int64_t month = mp < 10 ? mp + 3 : mp - 9;
+        const int64_t year = yoe + era * 400 + (month <= 2);
+
+        AppendUint(static_cast<uint64_t>(year), 4);
+        Append('-');
+        AppendUint(static_cast<uint64_t>(month), 2);
+        Append('-');
+        AppendUint(static_cast<uint64_t>(day), 2);
+        Append(' ');
+        AppendUint(static_cast<uint64_t>(rest / 3600), 2);
+        Append(':');
+        AppendUint(static_cast<uint64_t>(rest / 60 % 60), 2);
+        Append(':');
+        AppendUint(static_cast<uint64_t>(rest % 60), 2);
+        Append('.');
+        AppendUint(micros, 6);
+    }
+
+    void Flush() {
+        const char* data = buffer_;
+        while (size_ > 0) {
+            ssize_t n = ::write(fd_, data, size_);
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n <= 0) {
+                break;
+            }
+            data += n;
+            size_ -= static_cast<size_t>(n);
+        }
+        size_ = 0;
+    }
+
+private:
+    int fd_;
+    size_t size_ = 0;
+    char buffer_[kDumpBufferSize];
+};
+
+void HandleFatalSignal(int signal) {
+    int saved_errno = errno;
+    FlightRecorderAppender::DumpAll();
+    // 交还给原来的处理方式；信号在处理函数返回后重新递送
+    ::sigaction(signal, &g_previous[signal], nullptr);
+    ::raise(signal);
+    errno = saved_errno;
+}
+
+}  // namespace
+
+FlightRecorderAppender::FlightRecorderAppender(const std::string& dump_file,
+                                               size_t events,
+                                               size_t slot_size)
+    : Appender(AppenderType::FLIGHT, dump_file.empty() ? "stderr" : dump_file),
+      dump_file_(dump_file),
+      count_(RoundToPowerOfTwo(std::max<size_t>(events, 1))),
+      slot_size_(std::min((std::max(slot_size, sizeof(Slot) + 16) + 63) / 64 * 64,
+                          kMaxFlightSlotSize)) {
+    // 一次性映射并预先缺页，记录时不会再分配内存或触发缺页
+    void* addr = ::mmap(nullptr, count_ * slot_size_, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0);
+    if (addr == MAP_FAILED) {
+        throw std::runtime_error(
+            fmt::format("Could not allocate flight recorder of {} bytes, error: {}",
+                        count_ * slot_size_, std::strerror(errno)));
+    }
+    slots_ = static_cast<char*>(addr);
+    utc_offset_.store(LocalUtcOffset(), std::memory_order_relaxed);
+
+    bool registered = false;
+    for (auto& entry : g_recorders) {
+        FlightRecorderAppender* expected = nullptr;
+        if (entry.compare_exchange_strong(expected, this)) {
+            registered = true;
+            break;
+        }
+    }
+    if (!registered) {
+        fmt::println(stderr, "Too many flight recorders, '{}' will not be dumped on signals",
+                     name_);
+    }
+}
+
+FlightRecorderAppender::~FlightRecorderAppender() {
+    for (auto& entry : g_recorders) {
+        FlightRecorderAppender* expected = this;
+        if (entry.compare_exchange_strong(expected, nullptr)) {
+            break;
+        }
+    }
+    // 等待正在进行的写出（可能来自其他线程的 FATAL 事件）结束
+    while (dumping_.exchange(true, std::memory_order_acquire)) {
+    }
+    ::munmap(slots_, count_ * slot_size_);
+}
+
+void FlightRecorderAppender::Log(const std::shared_ptr<LogEvent> event, Level level) {
+    if (!level.cmp(event->level())) {
+        return;
+    }
+
+    Record(*event);
+    if (event->level().level() >= dump_level_.load(std::memory_order_relaxed)) {
+        Dump();
+    }
+}
+
+void FlightRecorderAppender::Record(const LogEvent& event) {
+    const uint64_t index = next_.fetch_add(1, std::memory_order_relaxed);
+    Slot* slot = SlotAt(index);
+
+    // 只有槽位空闲且属于更早的序号时才占用；槽位还在被上一圈的写入者使用时放弃本条，
+    // 保证任何时刻一个槽位只有一个写入者
+    const uint64_t writing = 2 * index + 1;
+    uint64_t current = slot->seq.load(std::memory_order_relaxed);
+    if ((current & 1) || current > writing ||
+        !slot->seq.compare_exchange_strong(current, writing, std::memory_order_acquire,
+                                           std::memory_order_relaxed)) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    slot->wall_ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                              event.timestamp().time_since_epoch())
+                                              .count());
+    slot->file = event.file();
+    slot->line = event.line();
+    slot->tid = event.tid();
+    slot->level = static_cast<uint8_t>(event.level().level());
+
+    char* text = reinterpret_cast<char*>(slot + 1);
+    size_t room = slot_size_ - sizeof(Slot);
+    static const std::string kNoLogger;
+    const std::string& logger = event.logger() ? event.logger()->name() : kNoLogger;
+    size_t logger_size = std::min<size_t>({logger.size(), room / 4, 255});
+    std::memcpy(text, logger.data(), logger_size);
+    fmt::string_view message = event.message();
+    size_t message_size = std::min(message.size(), room - logger_size);
+    std::memcpy(text + logger_size, message.data(), message_size);
+    slot->logger_size = static_cast<uint8_t>(logger_size);
+    slot->message_size = static_cast<uint16_t>(message_size);
+
+    slot->seq.store(writing + 1, std::memory_order_release);
+}
+
+size_t FlightRecorderAppender::Dump() {
+    utc_offset_.store(LocalUtcOffset(), std::memory_order_relaxed);
+    if (dump_file_.empty()) {
+        return DumpTo(STDERR_FILENO);
+    }
+    int fd = ::open(dump_file_.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        fmt::println(stderr, "Could not open file '{}', error: {}, dumping to stderr",
+                     dump_file_, std::strerror(errno));
+        return DumpTo(STDERR_FILENO);
+    }
+    size_t count = DumpTo(fd);
+    ::close(fd);
+    return count;
+}
+
+size_t FlightRecorderAppender::DumpTo(int fd) {
+    if (dumping_.exchange(true, std::memory_order_acquire)) {
+        return 0;
+    }
+
+    const uint64_t end = next_.load(std::memory_order_acquire);
+    const uint64_t begin = end > count_ ? end - count_ : 0;
+    const long offset = utc_offset_.load(std::memory_order_relaxed);
+
+    DumpWriter out(fd);
+    out.Append("----- flight recorder ");
+    out.Append(name_.c_str());
+    out.Append(": last ");
+    out.AppendUint(end - begin);
+    out.Append(" of ");
+    out.AppendUint(end);
+    out.Append(" events -----\n");
+
+    // 逐个槽位按序号读出：复制前后序号不变才说明读到的是完整的一条
+    alignas(64) char copy[kMaxFlightSlotSize];
+    const Slot* snapshot = reinterpret_cast<const Slot*>(copy);
+    size_t count = 0;
+    for (uint64_t index = begin; index < end; ++index) {
+        const Slot* slot = SlotAt(index);
+        const uint64_t done = 2 * index + 2;
+        if (slot->seq.load(std::memory_order_acquire) != done) {
+            continue;  // 还在写、已被覆盖或被放弃
+        }
+        std::memcpy(copy + sizeof(std::atomic<uint64_t>),
+                    reinterpret_cast<const char*>(slot) + sizeof(std::atomic<uint64_t>),
+                    slot_size_ - sizeof(std::atomic<uint64_t>));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot->seq.load(std::memory_order_relaxed) != done) {
+            continue;
+        }
+
+        const char* text = reinterpret_cast<const char*>(snapshot + 1);
+        const size_t logger_size = snapshot->logger_size;
+        const size_t message_size =
+            std::min<size_t>(snapshot->message_size, slot_size_ - sizeof(Slot) - logger_size);
+        out.Reserve(message_size + logger_size + 256);
+        out.AppendTime(static_cast<int64_t>(snapshot->wall_ns / 1000000000) + offset,
+                       static_cast<uint32_t>(snapshot->wall_ns % 1000000000 / 1000));
+        out.Append(" [");
+        out.Append(Level::Name(static_cast<LevelType>(snapshot->level)));
+        out.Append("] [");
+        out.Append(text, logger_size);
+        out.Append("] ");
+        out.Append(snapshot->file ? snapshot->file : "?");
+        out.Append(':');
+        out.AppendUint(snapshot->line);
+        out.Append(' ');
+        out.AppendUint(static_cast<uint32_t>(snapshot->tid));
+        out.Append(' ');
+        out.Append(text + logger_size, message_size);
+        out.Append('\n');
+        ++count;
+    }
+    out.Flush();
+
+    dumping_.store(false, std::memory_order_release);
+    return count;
+}
+
+void FlightRecorderAppender::SetDumpLevel(LevelType level) {
+    dump_level_.store(level, std::memory_order_relaxed);
+}
+
+size_t FlightRecorderAppender::EventsForBytes(size_t bytes, size_t slot_size) {
+    return std::max<size_t>(bytes / std::max<size_t>(slot_size, 1), 1);
+}
+
+size_t FlightRecorderAppender::DumpAll() {
+    size_t count = 0;
+    for (auto& entry : g_recorders) {
+        FlightRecorderAppender* recorder = entry.load(std::memory_order_acquire);
+        if (!recorder) {
+            continue;
+        }
+        if (recorder->dump_file_.empty()) {
+            count += recorder->DumpTo(STDERR_FILENO);
+            continue;
+        }
+        int fd = ::open(recorder->dump_file_.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC,
+                        0644);
+        count += recorder->DumpTo(fd >= 0 ? fd : STDERR_FILENO);
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+    return count;
+}
+
+void FlightRecorderAppender::InstallSignalHandlers() {
+    if (g_handlers_installed.exchange(true)) {
+        return;
+    }
+    struct sigaction action = {};
+    action.sa_handler = HandleFatalSignal;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_ONSTACK;  // 线程设置了 sigaltstack 时，栈溢出也能写出
+    for (int signal : kFatalSignals) {
+        ::sigaction(signal, &action, &g_previous[signal]);
+    }
+}
+
+}  // namespace log
+}  // namespace rein
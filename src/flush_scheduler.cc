@@ -0,0 +1,77 @@
+#include "log/flush_scheduler.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "log/appender.h"
+
+namespace rein {
+namespace log {
+
+FlushScheduler& FlushScheduler::instance() {
+    // 进程退出时 Appender 可能晚于静态对象析构，调度器刻意不析构
+    static FlushScheduler* scheduler = new FlushScheduler();
+    return *scheduler;
+}
+
+void FlushScheduler::Register(Appender* appender, std::chrono::milliseconds interval) {
+    Register(appender, interval, nullptr);
+}
+
+void FlushScheduler::Register(Appender* appender,
+                              std::chrono::milliseconds interval,
+                              std::function<void()> task) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto due = std::chrono::steady_clock::now() + interval;
+    auto it = std::find_if(entries_.begin(), entries_.end(),
+                           [&](const Entry& entry) { return entry.appender == appender; });
+    if (it != entries_.end()) {
+        it->interval = interval;
+        it->due = due;
+        it->task = std::move(task);
+    } else {
+        entries_.push_back({appender, interval, due, std::move(task)});
+    }
+
+    if (!started_) {
+        std::thread(&FlushScheduler::Run, this).detach();
+        started_ = true;
+    }
+    cv_.notify_one();
+}
+
+void FlushScheduler::Unregister(Appender* appender) {
+    // 与 Run() 持有同一把锁：返回时后台线程不可能正在刷新该 Appender
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.erase(std::remove_if(entries_.begin(), entries_.end(),
+                                  [&](const Entry& entry) { return entry.appender == appender; }),
+                   entries_.end());
+}
+
+void FlushScheduler::Run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        if (entries_.empty()) {
+            cv_.wait(lock);
+            continue;
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        auto next = entries_.front().due;
+        for (auto& entry : entries_) {
+            if (entry.due <= now) {
+                if (entry.task) {
+                    entry.task();
+                } else {
+                    entry.appender->Flush();
+                }
+                entry.due = now + entry.interval;
+            }
+            next = std::min(next, entry.due);
+        }
+        cv_.wait_until(lock, next);
+    }
+}
+
+}  // namespace log
+}  // namespace rein
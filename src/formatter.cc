@@ -1,8 +1,13 @@
 #include "log/formatter.h"
 
+#include <chrono>
+#include <cstring>
 #include <ctime>
 #include <iterator>  // for std::back_inserter
-#include <chrono>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
 
 #include <fmt/chrono.h>
 
@@ -13,79 +18,194 @@
 namespace rein {
 namespace log {
 
-void NameFormatter::format(fmt::memory_buffer &buffer, const std::shared_ptr<LogEvent> &event) {
-    fmt::format_to(std::back_inserter(buffer), "{}", event->logger()->name());
-}
-
-DateTimeFormatter::DateTimeFormatter(const std::string &format)
-    : format_(std::move(format)) {}
-
-void DateTimeFormatter::format(fmt::memory_buffer &buffer, const std::shared_ptr<LogEvent> &event) {
-    auto timestamp = event->timestamp();
-    std::time_t time = std::chrono::system_clock::to_time_t(timestamp);  // 转换秒级时间
-    std::tm local_tm;
-    localtime_r(&time, &local_tm);
-
-    // 计算毫秒
-    auto tp_sec = std::chrono::system_clock::from_time_t(time);
-    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(timestamp - tp_sec).count();
-
-    size_t dot_f_pos = format_.find(".%f");
-    if (dot_f_pos == std::string::npos) {
-        // 没有找到毫秒占位符，直接格式化
-        fmt::format_to(std::back_inserter(buffer), fmt::runtime("{" + format_ + "}"), local_tm);
-        return;
+namespace {
+
+// 每隔多少秒重新向 libc 查询一次 UTC 偏移（夏令时切换都发生在 15 分钟的整数倍上）
+constexpr std::time_t kOffsetRefreshSeconds = 15 * 60;
+// 每个线程缓存的时间格式个数（按格式串区分，一个进程通常只会用到一两种）
+constexpr size_t kDateTimeCacheSlots = 4;
+
+// 格式串 -> 编号。格式相同的 DateTimeFormatter 共用同一个编号，也就共用同一份 thread_local 缓存，
+// 异步模式下一个后台线程服务再多的 Appender，只要时间格式相同就不会互相挤掉缓存
+uint64_t PatternId(const std::string &pattern) {
+    static std::mutex mutex;
+    static std::unordered_map<std::string, uint64_t> ids;
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = ids.find(pattern);
+    if (it == ids.end()) {
+        it = ids.emplace(pattern, ids.size() + 1).first;
     }
-
-    // 如果有.%f，就使用字符串
-    std::string prefix_format = "{" + format_.substr(0, dot_f_pos) + "}";
-    std::string time_str = fmt::format(fmt::runtime(prefix_format), local_tm);
-
-    fmt::format_to(std::back_inserter(buffer), "{}{}", time_str, fmt::format(".{:03}", ms));
+    return it->second;
 }
 
-void FileNameFormatter::format(fmt::memory_buffer &buffer, const std::shared_ptr<LogEvent> &event) {
-    fmt::format_to(std::back_inserter(buffer), "{}", event->file());
+std::time_t FloorDiv(std::time_t value, std::time_t divisor) {
+    std::time_t q = value / divisor;
+    return (value % divisor < 0) ? q - 1 : q;
 }
 
-void LineFormatter::format(fmt::memory_buffer &buffer, const std::shared_ptr<LogEvent> &event) {
-    fmt::format_to(std::back_inserter(buffer), "{}", event->line());
+// UTC 秒数换算为日历时间，不查询时区、不加锁（Howard Hinnant 的 civil_from_days 算法）
+void CivilFromSeconds(std::time_t seconds, std::tm &tm) {
+    std::time_t days = FloorDiv(seconds, 86400);
+    std::time_t secs = seconds - days * 86400;
+    tm.tm_hour = static_cast<int>(secs / 3600);
+    tm.tm_min = static_cast<int>(secs % 3600 / 60);
+    tm.tm_sec = static_cast<int>(secs % 60);
+    tm.tm_wday = static_cast<int>(days + 4 - FloorDiv(days + 4, 7) * 7);  // 1970-01-01 是周四
+
+    std::time_t z = days + 719468;
+    std::time_t era = FloorDiv(z, 146097);
+    std::time_t doe = z - era * 146097;
+    std::time_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    std::time_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    std::time_t mp = (5 * doy + 2) / 153;
+    std::time_t day = doy - (153 * mp + 2) / 5 + 1;
+    std::time_t month = mp < 10 ? mp + 3 : mp - 9;
+    std::time_t year = yoe + era * 400 + (month <= 2 ? 1 : 0);
+
+    static const int kDaysBeforeMonth[] = {0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334};
+    bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+    tm.tm_year = static_cast<int>(year - 1900);
+    tm.tm_mon = static_cast<int>(month - 1);
+    tm.tm_mday = static_cast<int>(day);
+    tm.tm_yday = kDaysBeforeMonth[tm.tm_mon] + tm.tm_mday - 1 + ((leap && month > 2) ? 1 : 0);
 }
 
-void MessageFormatter::format(fmt::memory_buffer &buffer, const std::shared_ptr<LogEvent> &event) {
-    fmt::format_to(std::back_inserter(buffer), "{}", event->message());
+// 以固定宽度写入 value 的低 digits 位（不足补 0）
+void AppendDigits(fmt::memory_buffer &buffer, uint32_t value, int digits) {
+    char out[9];
+    for (int i = digits - 1; i >= 0; --i) {
+        out[i] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    }
+    buffer.append(out, out + digits);
 }
 
-void NewLineFormatter::format(fmt::memory_buffer &buffer, const std::shared_ptr<LogEvent> &event) {
-    fmt::format_to(std::back_inserter(buffer), "\n");
-}
+}  // namespace
 
-void ThreadIdFormatter::format(fmt::memory_buffer &buffer, const std::shared_ptr<LogEvent> &event) {
-    fmt::format_to(std::back_inserter(buffer), "{}", event->pthread_id());
-}
+struct DateTimeFormatter::Cache {
+    uint64_t owner = 0;                                             // 格式串编号，见 PatternId
+    std::time_t second = std::numeric_limits<std::time_t>::min();  // 缓存的是哪一秒
+    std::time_t offset_epoch = std::numeric_limits<std::time_t>::min();
+    long utc_offset = 0;                                            // 本地时间相对 UTC 的秒数
+    int is_dst = 0;
+    const char *zone = nullptr;                                     // %Z 使用的时区缩写
+    fmt::basic_memory_buffer<char, 64> prefix;
+    fmt::basic_memory_buffer<char, 32> suffix;
+};
 
-void ThreadNameFormatter::format(fmt::memory_buffer &buffer,
-                                 const std::shared_ptr<LogEvent> &event) {
-    fmt::format_to(std::back_inserter(buffer), "{}", event->thread_name());
-}
+DateTimeFormatter::DateTimeFormatter(const std::string &format)
+    : format_(std::move(format)),
+      subsecond_digits_(0),
+      id_(PatternId(format_)) {
+    // 格式串在构造时一次性拆分好：前缀 + 亚秒位 + 后缀
+    std::string spec = format_;
+    if (!spec.empty() && spec[0] == ':') {
+        spec.erase(0, 1);
+    }
 
-void LevelFormatter::format(fmt::memory_buffer &buffer, const std::shared_ptr<LogEvent> &event) {
-    fmt::format_to(std::back_inserter(buffer), "{}", event->level().string());
-}
+    static const struct {
+        const char *token;
+        int digits;
+    } kSubsecond[] = {{"%3f", 3}, {"%6f", 6}, {"%9f", 9}, {"%f", 3}};
+
+    std::string prefix = spec;
+    for (const auto &placeholder : kSubsecond) {
+        size_t pos = spec.find(placeholder.token);
+        if (pos != std::string::npos) {
+            prefix = spec.substr(0, pos);
+            std::string suffix = spec.substr(pos + std::strlen(placeholder.token));
+            if (!suffix.empty()) {
+                suffix_format_ = "{:" + suffix + "}";
+            }
+            subsecond_digits_ = placeholder.digits;
+            break;
+        }
+    }
 
-void ElapseFormatter::format(fmt::memory_buffer &buffer, const std::shared_ptr<LogEvent> &event) {
-    fmt::format_to(std::back_inserter(buffer), "{}", event->elapse());
+    if (!prefix.empty()) {
+        prefix_format_ = "{:" + prefix + "}";
+    } else if (subsecond_digits_ == 0) {
+        prefix_format_ = "{}";  // 未指定格式，使用 fmt 的默认日期格式
+    }
+
+    // 提前校验格式串，错误在构造布局时就抛出
+    std::tm tm = {};
+    std::time_t epoch = 0;
+    localtime_r(&epoch, &tm);
+    fmt::memory_buffer probe;
+    if (!prefix_format_.empty()) {
+        fmt::format_to(std::back_inserter(probe), fmt::runtime(prefix_format_), tm);
+    }
+    if (!suffix_format_.empty()) {
+        fmt::format_to(std::back_inserter(probe), fmt::runtime(suffix_format_), tm);
+    }
 }
 
-void TabFormatter::format(fmt::memory_buffer &buffer, const std::shared_ptr<LogEvent> &event) {
-    fmt::format_to(std::back_inserter(buffer), "\t");
+void DateTimeFormatter::Render(Cache &cache, std::time_t seconds) const {
+    std::tm tm = {};
+    std::time_t epoch = FloorDiv(seconds, kOffsetRefreshSeconds);
+    if (epoch != cache.offset_epoch) {
+        // 每个线程每 15 分钟才走一次带时区锁的 localtime_r，顺便更新偏移
+        localtime_r(&seconds, &tm);
+        cache.offset_epoch = epoch;
+        cache.utc_offset = tm.tm_gmtoff;
+        cache.is_dst = tm.tm_isdst;
+        cache.zone = tm.tm_zone;
+    } else {
+        CivilFromSeconds(seconds + cache.utc_offset, tm);
+        tm.tm_isdst = cache.is_dst;
+        tm.tm_gmtoff = cache.utc_offset;
+        tm.tm_zone = cache.zone;
+    }
+
+    cache.prefix.clear();
+    cache.suffix.clear();
+    if (!prefix_format_.empty()) {
+        fmt::format_to(std::back_inserter(cache.prefix), fmt::runtime(prefix_format_), tm);
+    }
+    if (!suffix_format_.empty()) {
+        fmt::format_to(std::back_inserter(cache.suffix), fmt::runtime(suffix_format_), tm);
+    }
+    cache.second = seconds;
 }
 
-StringFormatter::StringFormatter(const std::string &str)
-    : str_(std::move(str)) {}
+void DateTimeFormatter::format(fmt::memory_buffer &buffer, const std::shared_ptr<LogEvent> &event) {
+    thread_local Cache caches[kDateTimeCacheSlots];
+    thread_local size_t next_slot = 0;
+
+    Cache *cache = nullptr;
+    for (auto &slot : caches) {
+        if (slot.owner == id_) {
+            cache = &slot;
+            break;
+        }
+    }
+    if (!cache) {
+        cache = &caches[next_slot++ % kDateTimeCacheSlots];
+        *cache = Cache();
+        cache->owner = id_;
+    }
+
+    int64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                     event->timestamp().time_since_epoch())
+                     .count();
+    std::time_t seconds = static_cast<std::time_t>(FloorDiv(ns, 1000000000));
+    auto subsecond = static_cast<uint32_t>(ns - static_cast<int64_t>(seconds) * 1000000000);
 
-void StringFormatter::format(fmt::memory_buffer &buffer, const std::shared_ptr<LogEvent> &event) {
-    fmt::format_to(std::back_inserter(buffer), "{}", str_);
+    if (cache->second != seconds) {
+        Render(*cache, seconds);
+    }
+
+    buffer.append(cache->prefix.data(), cache->prefix.data() + cache->prefix.size());
+    if (subsecond_digits_ == 3) {
+        AppendDigits(buffer, subsecond / 1000000, 3);
+    } else if (subsecond_digits_ == 6) {
+        AppendDigits(buffer, subsecond / 1000, 6);
+    } else if (subsecond_digits_ == 9) {
+        AppendDigits(buffer, subsecond, 9);
+    }
+    buffer.append(cache->suffix.data(), cache->suffix.data() + cache->suffix.size());
 }
+
 }  // namespace log
 }  // namespace rein
\ No newline at end of file
@@ -15,61 +15,163 @@
 
 #include "log/event.h"
 #include "log/formatter.h"
+#include "log/logger.h"
 
 namespace rein {
 namespace log {
 
-// 模板工厂函数：创建无参数的FormatterItem
-template <typename Type>
-Layout::FormatterFactory make_factory() {
-    return []() { return std::make_shared<Type>(); };
+namespace {
+
+inline void AppendView(fmt::memory_buffer &buffer, const char *data, size_t size) {
+    buffer.append(data, data + size);
 }
 
-// 模板工厂函数：创建带参数的FormatterItem
-template <typename Type>
-Layout::FormatterFactory make_factory(const std::string &param) {
-    return [param]() { return std::make_shared<Type>(param); };
+template <typename T>
+inline void AppendInt(fmt::memory_buffer &buffer, T value) {
+    fmt::format_int digits(value);
+    buffer.append(digits.data(), digits.data() + digits.size());
 }
 
-const std::map<std::string, Layout::FormatterFactory> Layout::formatters_ = {
-    {"c", make_factory<NameFormatter>()},
-    {"d", make_factory<DateTimeFormatter>("")},  // 实际参数在解析时提取
-    {"f", make_factory<FileNameFormatter>()},           // 文件名
-    {"l", make_factory<LineFormatter>()},
-    {"m", make_factory<MessageFormatter>()},
-    {"n", make_factory<NewLineFormatter>()},
-    {"N", make_factory<ThreadNameFormatter>()},
-    {"p", make_factory<LevelFormatter>()},
-    {"r", make_factory<ElapseFormatter>()},
-    {"T", make_factory<TabFormatter>()},
-    {"s", make_factory<StringFormatter>("")},
-    {"t", make_factory<ThreadIdFormatter>()}};
+}  // namespace
 
 Layout::Layout(const std::string &pattern)
     : pattern_(std::move(pattern)) {
     parse_pattern();
 }
 
+void Layout::format(fmt::memory_buffer &buffer, const std::shared_ptr<LogEvent> &event) {
+    const LogEvent &ev = *event;
+    for (const auto &inst : program_) {
+        switch (inst.op) {
+            case OpCode::kLiteral:
+                AppendView(buffer, literals_.data() + inst.offset, inst.size);
+                break;
+            case OpCode::kItem:
+                items_[inst.offset]->format(buffer, event);
+                break;
+            case OpCode::kLoggerName: {
+                const std::string &name = ev.logger()->name();
+                AppendView(buffer, name.data(), name.size());
+                break;
+            }
+            case OpCode::kFileName:
+                AppendView(buffer, ev.file(), std::strlen(ev.file()));
+                break;
+            case OpCode::kLine:
+                AppendInt(buffer, ev.line());
+                break;
+            case OpCode::kMessage: {
+                auto message = ev.message();
+                AppendView(buffer, message.data(), message.size());
+                break;
+            }
+            case OpCode::kThreadName:
+                AppendView(buffer, ev.thread_name(), std::strlen(ev.thread_name()));
+                break;
+            case OpCode::kLevel: {
+                const char *name = Level::Name(ev.level().level());
+                AppendView(buffer, name, std::strlen(name));
+                break;
+            }
+            case OpCode::kElapse:
+                AppendInt(buffer, ev.elapse());
+                break;
+            case OpCode::kThreadId:
+                AppendInt(buffer, static_cast<unsigned long long>(ev.pthread_id()));
+                break;
+            case OpCode::kKernelTid:
+                AppendInt(buffer, ev.tid());
+                break;
+        }
+    }
+}
+
 std::string Layout::format(const std::shared_ptr<LogEvent> &event) {
-    return format(event, Level());
+    fmt::memory_buffer buffer;
+    format(buffer, event);
+    return fmt::to_string(buffer);
 }
 
 std::string Layout::format(const std::shared_ptr<LogEvent> &event, Level level) {
-    if (!event->level().cmp(level)) {
+    // level 为阈值：事件级别不低于阈值才输出
+    if (!level.cmp(event->level())) {
         return "";
     }
-    fmt::memory_buffer buffer;
-    for (const auto &item : items_) {
-        item->format(buffer, event);
+    return format(event);
+}
+
+void Layout::EmitLiteral(const std::string &text) {
+    if (text.empty()) {
+        return;
+    }
+    // 与前一段字面量相邻时直接延长，格式化时少一条指令
+    if (!program_.empty() && program_.back().op == OpCode::kLiteral &&
+        program_.back().offset + program_.back().size == literals_.size()) {
+        program_.back().size += static_cast<uint32_t>(text.size());
+    } else {
+        program_.push_back({OpCode::kLiteral, static_cast<uint32_t>(literals_.size()),
+                            static_cast<uint32_t>(text.size())});
+    }
+    literals_.append(text);
+}
+
+void Layout::Emit(char specifier, const std::string &param) {
+    switch (specifier) {
+        case 'c':
+            program_.push_back({OpCode::kLoggerName, 0, 0});
+            break;
+        case 'd':
+            program_.push_back({OpCode::kItem, static_cast<uint32_t>(items_.size()), 0});
+            items_.emplace_back(new DateTimeFormatter(param));
+            break;
+        case 'f':
+            program_.push_back({OpCode::kFileName, 0, 0});
+            break;
+        case 'l':
+            program_.push_back({OpCode::kLine, 0, 0});
+            break;
+        case 'm':
+            program_.push_back({OpCode::kMessage, 0, 0});
+            break;
+        case 'n':
+            EmitLiteral("\n");
+            break;
+        case 'N':
+            program_.push_back({OpCode::kThreadName, 0, 0});
+            break;
+        case 'p':
+            program_.push_back({OpCode::kLevel, 0, 0});
+            break;
+        case 'r':
+            program_.push_back({OpCode::kElapse, 0, 0});
+            break;
+        case 'T':
+            EmitLiteral("\t");
+            break;
+        case 's':
+            EmitLiteral(param);
+            break;
+        case 't':
+            // %t 输出 pthread_t；%t{tid} 输出内核线程号（gettid），可以与 top/perf 对应
+            if (param == "tid") {
+                program_.push_back({OpCode::kKernelTid, 0, 0});
+            } else if (param.empty()) {
+                program_.push_back({OpCode::kThreadId, 0, 0});
+            } else {
+                throw std::logic_error("Invalid pattern: unknown %t parameter - " + param);
+            }
+            break;
+        default:
+            throw std::logic_error("Invalid pattern: unknown format specifier - " +
+                                   std::string(1, specifier));
     }
-    return fmt::to_string(buffer);
 }
 
 // %d{%Y-%m-%d %H:%M%S.%f} [%p] %f:%l%m%n
 void Layout::parse_pattern() {
     std::string buffer;
 
-    for (int i = 0; i < pattern_.size(); ++i) {
+    for (size_t i = 0; i < pattern_.size(); ++i) {
         // 处理普通字符串
         if (pattern_[i] != '%') {
             buffer.append(1, pattern_[i]);
@@ -84,17 +186,15 @@ void Layout::parse_pattern() {
         }
 
         // 处理格式说明
-        if (!buffer.empty()) {
-            items_.push_back(std::make_shared<StringFormatter>(buffer));
-            buffer.clear();
-        }
+        EmitLiteral(buffer);
+        buffer.clear();
 
         i++;  // 移动到%后面
         if (i >= pattern_.size()) {
             throw std::logic_error("Invalid pattern: pattern ends with a single '%'");
         }
 
-        std::string specifier_str(1, pattern_[i]);
+        char specifier = pattern_[i];
         std::string param;
 
         // 检查是否携带参数 {...}
@@ -108,34 +208,10 @@ void Layout::parse_pattern() {
             i = end_brace_pos;
         }
 
-        auto it = formatters_.find(specifier_str);
-        if (it == formatters_.end()) {
-            std::string error_msg = "Invalid pattern: unknown format specifier - " + specifier_str;
-            throw std::logic_error(error_msg);
-        }
-
-        if (!param.empty()) {
-            // 特殊处理带有参数的类型
-            if (specifier_str == "d") {
-                items_.push_back(std::make_shared<DateTimeFormatter>(param));
-            } else if (specifier_str == "s") {
-                items_.push_back(std::make_shared<StringFormatter>(param));
-            } else {
-                items_.push_back(it->second());
-            }
-        } else {
-            items_.push_back(it->second());
-        }
-
-        // 处理最后的普通字符串
-        if (!buffer.empty()) {
-            items_.push_back(std::make_shared<StringFormatter>(buffer));
-        }
+        Emit(specifier, param);
     }
 
-    if (!buffer.empty()) {
-    items_.push_back(std::make_shared<StringFormatter>(buffer));
-}
+    EmitLiteral(buffer);
 }
 
 }  // namespace log
@@ -36,6 +36,23 @@ std::string Level::ToString(const LevelType& level) {
     return (it != level_map_.end()) ? it->second : "UNKNOWN";
 }
 
+const char* Level::Name(LevelType level) {
+    switch (level) {
+        case LevelType::kDebug:
+            return "DEBUG";
+        case LevelType::kInfo:
+            return "INFO";
+        case LevelType::kWarn:
+            return "WARN";
+        case LevelType::kError:
+            return "ERROR";
+        case LevelType::kFatal:
+            return "FATAL";
+        default:
+            return "UNKNOWN";
+    }
+}
+
 LevelType Level::level() const { return level_; }
 
 void Level::setLevelFromEnum(LevelType level) {
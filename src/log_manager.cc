@@ -29,6 +29,8 @@ LogManager::LogManager() {
     loggers_[kRootLoggerName] = root_logger_;
 }
 
+LogManager::~LogManager() { Shutdown(); }
+
 // 获取 root logger
 std::shared_ptr<Logger> LogManager::root_logger() { return root_logger_; }
 
@@ -69,6 +71,9 @@ void LogManager::AddLogger(const std::string& logger_name,
     }
     appender->SetLayout(layout);
     new_logger->AddAppender(appender);
+    if (async_) {
+        new_logger->SetAsync(async_);
+    }
     loggers_[logger_name] = new_logger;
 }
 
@@ -163,5 +168,92 @@ void LogManager::SetLayout(const std::string& logger_name,
     target_appender->SetLayout(layout);
 }
 
+void LogManager::EnableAsync(size_t capacity, OverflowPolicy policy) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto worker = std::make_shared<AsyncWorker>(capacity, policy);
+    workers_.push_back(worker);
+    async_ = worker;
+
+    for (auto& it : loggers_) {
+        it.second->SetAsync(worker);
+    }
+}
+
+void LogManager::EnableAsync(const std::string& logger_name,
+                             size_t capacity,
+                             OverflowPolicy policy) {
+    auto target_logger = logger(logger_name);
+
+    if (!target_logger) {
+        fmt::println(stderr, "Error: Cannot enable async, logger '{}' not found.", logger_name);
+        return;
+    }
+
+    auto worker = std::make_shared<AsyncWorker>(capacity, policy);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        workers_.push_back(worker);
+    }
+    target_logger->SetAsync(worker);
+}
+
+void LogManager::DisableAsync() {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    for (auto& it : loggers_) {
+        it.second->SetAsync(nullptr);
+    }
+    async_.reset();
+
+    // 仍可能有线程持有旧 worker 的指针，Stop 之后其 Push 会退化为同步输出
+    for (auto& worker : workers_) {
+        worker->Stop();
+    }
+    workers_.clear();
+}
+
+void LogManager::Flush() {
+    std::vector<std::shared_ptr<AsyncWorker>> workers;
+    std::vector<std::shared_ptr<Logger>> loggers;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        workers = workers_;
+        for (auto& it : loggers_) {
+            loggers.push_back(it.second);
+        }
+    }
+
+    for (auto& worker : workers) {
+        worker->Flush();
+    }
+    for (auto& logger : loggers) {
+        logger->Flush();
+    }
+}
+
+void LogManager::Shutdown() {
+    std::vector<std::shared_ptr<AsyncWorker>> workers;
+    std::vector<std::shared_ptr<Logger>> loggers;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        workers = workers_;
+        for (auto& it : loggers_) {
+            loggers.push_back(it.second);
+        }
+    }
+
+    for (auto& worker : workers) {
+        worker->Stop();
+    }
+    for (auto& logger : loggers) {
+        logger->Flush();
+    }
+}
+
+void LogManager::SetClock(ClockType type) { Clock::Set(type); }
+
+ClockType LogManager::clock() const { return Clock::type(); }
+
 }  // namespace log
-}  // namespace rein
\ No newline at end of file
+}  // namespace rein
@@ -7,30 +7,117 @@
 #include <stdexcept>
 #include "fmt/base.h"
 #include "log/appender.h"
+#include "log/async_worker.h"
+#include "log/layout.h"
+#include "log/object_pool.hpp"
 
 namespace rein {
 namespace log {
 Logger::Logger(const std::string& name, Level level)
     : name_(std::move(name)),
-      level_(level) {}
+      level_(level.level()),
+      appenders_(std::make_shared<AppenderList>()),
+      deferred_(false),
+      async_(nullptr) {}
 
-void Logger::log(
-    Level level, const char* file, uint32_t line, const char* func, const std::string& message) {
-    // 创建 LogEvent 对象
-    // 使用 shared_from_this() 来获取当前 Logger 对象的 shared_ptr
-    auto event = std::make_shared<LogEvent>(level, file, line, func, message, shared_from_this());
+std::shared_ptr<LogEvent> Logger::MakeEvent(Level level,
+                                           const char* file,
+                                           uint32_t line,
+                                           const char* func) {
+    // 事件与控制块一起从 BlockPool 分配，释放时归还池中复用
+    return std::allocate_shared<LogEvent>(PoolAllocator<LogEvent>(), level, file, line, func,
+                                          shared_from_this());
+}
 
-    // 使用互斥锁保护 appenders_ 列表，因为其他线程可能正在添加或删除 appender
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (!appenders_.empty()) {
-        for (auto& appender : appenders_) {
-            // 将事件分发给每个 appender
-            // Appender 内部会再进行一次级别检查
-            appender->Log(event, appender->level());
+void Logger::Post(std::shared_ptr<LogEvent> event) {
+    // 异步模式：只入队，由后台线程调用 CallAppenders
+    AsyncWorker* worker = async_.load(std::memory_order_acquire);
+    if (worker) {
+        worker->Push(std::move(event));
+        return;
+    }
+
+    CallAppenders(event);
+}
+
+void Logger::CallAppenders(const std::shared_ptr<LogEvent>& event) {
+    // 只在取快照时加锁，Appender 的输出（可能阻塞在磁盘或网络上）不持有 Logger 的锁
+    std::shared_ptr<const AppenderList> snapshot;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        snapshot = appenders_;
+    }
+    const AppenderList& appenders = *snapshot;
+    if (appenders.size() == 1) {
+        appenders[0]->Log(event, appenders[0]->level());
+        return;
+    }
+
+    // 布局相同的 Appender 只渲染一次：结果依次放在同一块缓冲区里，按布局记下位置。
+    // 布局取自各 Appender 加锁后的快照并持有到本次分发结束，SetLayout 与渲染可以并发
+    struct Rendered {
+        std::shared_ptr<Layout> layout;
+        size_t offset;
+        size_t size;
+    };
+    Rendered rendered[kMaxSharedLayouts];
+    size_t rendered_count = 0;
+
+    // 每次分发一块栈上缓冲区：Appender 内部再次记录日志（重入）时不会改写外层的渲染结果
+    fmt::memory_buffer buffer;
+
+    for (size_t i = 0; i < appenders.size(); ++i) {
+        Appender* appender = appenders[i].get();
+        Level level = appender->level();
+        if (!level.cmp(event->level())) {
+            continue;
+        }
+        std::shared_ptr<Layout> layout =
+            appender->SupportsPreformatted() ? appender->layout() : nullptr;
+        if (!layout) {
+            appender->Log(event, level);
+            continue;
+        }
+
+        const Rendered* found = nullptr;
+        for (size_t j = 0; j < rendered_count; ++j) {
+            if (SameLayout(rendered[j].layout.get(), layout.get())) {
+                found = &rendered[j];
+                break;
+            }
+        }
+
+        if (!found) {
+            // 后面没有同布局的 Appender 时直接写进它自己的缓冲区，省掉一次拷贝
+            bool shared = false;
+            for (size_t j = i + 1; j < appenders.size() && !shared; ++j) {
+                if (!appenders[j]->SupportsPreformatted()) {
+                    continue;
+                }
+                std::shared_ptr<Layout> other = appenders[j]->layout();
+                shared = other && SameLayout(layout.get(), other.get());
+            }
+            if (!shared || rendered_count == kMaxSharedLayouts) {
+                appender->Log(event, level);
+                continue;
+            }
+
+            Rendered& slot = rendered[rendered_count++];
+            slot.layout = std::move(layout);
+            slot.offset = buffer.size();
+            slot.layout->format(buffer, event);
+            slot.size = buffer.size() - slot.offset;
+            found = &slot;
         }
+
+        appender->Write(event, fmt::string_view(buffer.data() + found->offset, found->size));
     }
 }
 
+bool Logger::SameLayout(const Layout* lhs, const Layout* rhs) {
+    return lhs == rhs || lhs->pattern() == rhs->pattern();
+}
+
 void Logger::AddAppender(AppenderType type, const std::string& out) {
     try {
         auto app = AppenderFactory::CreateAppender(type, out);
@@ -49,9 +136,11 @@ void Logger::AddAppender(std::shared_ptr<Appender> appender) {
     }
     std::lock_guard<std::mutex> lock(mutex_);
     // 检查是否已存在
-    auto it = std::find(appenders_.begin(), appenders_.end(), appender);
-    if (it == appenders_.end()) {
-        appenders_.push_back(appender);
+    auto it = std::find(appenders_->begin(), appenders_->end(), appender);
+    if (it == appenders_->end()) {
+        auto list = std::make_shared<AppenderList>(*appenders_);
+        list->push_back(appender);
+        appenders_ = std::move(list);
     } else {
         throw std::runtime_error(
             fmt::format("Appender '{}' already exists in logger", appender->type_str()));
@@ -61,9 +150,11 @@ void Logger::AddAppender(std::shared_ptr<Appender> appender) {
 void Logger::RemoveAppender(AppenderType type, const std::string& name) {
     std::lock_guard<std::mutex> lock(mutex_);
 
-    for (auto it = appenders_.begin(); it != appenders_.end(); it++) {
+    for (auto it = appenders_->begin(); it != appenders_->end(); it++) {
         if ((*it)->type() == type && (*it)->name() == name) {
-            it = appenders_.erase(it);
+            auto list = std::make_shared<AppenderList>(*appenders_);
+            list->erase(list->begin() + (it - appenders_->begin()));
+            appenders_ = std::move(list);
             return;
         }
     }
@@ -72,7 +163,8 @@ void Logger::RemoveAppender(AppenderType type, const std::string& name) {
 void Logger::RemoveAppender(AppenderType type) {
     std::lock_guard<std::mutex> lock(mutex_);
 
-    auto new_end = std::remove_if(appenders_.begin(), appenders_.end(),
+    auto list = std::make_shared<AppenderList>(*appenders_);
+    auto new_end = std::remove_if(list->begin(), list->end(),
                                   [&](const std::shared_ptr<Appender>& appender) {
                                       if (appender->type() == type) {
                                           return true;
@@ -80,7 +172,8 @@ void Logger::RemoveAppender(AppenderType type) {
                                       return false;
                                   });
 
-    appenders_.erase(new_end, appenders_.end());
+    list->erase(new_end, list->end());
+    appenders_ = std::move(list);
 }
 
 void Logger::RemoveAppender(std::shared_ptr<Appender> appender) {
@@ -88,25 +181,71 @@ void Logger::RemoveAppender(std::shared_ptr<Appender> appender) {
         throw std::invalid_argument("Cannot del null Appender from logger");
     }
     std::lock_guard<std::mutex> lock(mutex_);
-    auto it = std::find(appenders_.begin(), appenders_.end(), appender);
-    if (it != appenders_.end()) {
-        appenders_.erase(it);
+    auto it = std::find(appenders_->begin(), appenders_->end(), appender);
+    if (it != appenders_->end()) {
+        auto list = std::make_shared<AppenderList>(*appenders_);
+        list->erase(list->begin() + (it - appenders_->begin()));
+        appenders_ = std::move(list);
     }
 }
 
 void Logger::ClearAppenders() {
     std::lock_guard<std::mutex> lock(mutex_);
-    appenders_.clear();
+    appenders_ = std::make_shared<AppenderList>();
 }
 
-void Logger::SetLevel(Level level) {
+void Logger::SetLevel(Level level) { level_.store(level.level(), std::memory_order_relaxed); }
+
+void Logger::SetAsync(std::shared_ptr<AsyncWorker> worker) {
+    std::shared_ptr<AsyncWorker> old;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (worker == async_owner_) {
+            return;
+        }
+        old = async_owner_;
+        async_owner_ = worker;
+        async_.store(worker.get(), std::memory_order_release);
+        if (old) {
+            retired_async_.push_back(old);
+        }
+    }
+
+    // 切换前提交的日志先输出，保证顺序
+    if (old) {
+        old->Flush();
+    }
+}
+
+std::shared_ptr<AsyncWorker> Logger::async() const {
     std::lock_guard<std::mutex> lock(mutex_);
-    level_ = level;
+    return async_owner_;
+}
+
+void Logger::SetDeferred(bool deferred) { deferred_.store(deferred, std::memory_order_relaxed); }
+
+bool Logger::deferred() const { return deferred_.load(std::memory_order_relaxed); }
+
+void Logger::Flush() {
+    auto worker = async();
+    if (worker) {
+        worker->Flush();
+    }
+
+    // 再把各 Appender 缓冲中的数据交给内核
+    std::shared_ptr<const AppenderList> snapshot;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        snapshot = appenders_;
+    }
+    for (auto& appender : *snapshot) {
+        appender->Flush();
+    }
 }
 
 std::shared_ptr<Appender> Logger::appender(AppenderType type, const std::string& name) {
     std::lock_guard<std::mutex> lock(mutex_);
-    for (auto it : appenders_) {
+    for (auto it : *appenders_) {
         if (it->name() == name && it->type() == type) {
             return it;
         }
@@ -114,11 +253,7 @@ std::shared_ptr<Appender> Logger::appender(AppenderType type, const std::string&
     return nullptr;
 }
 
-Level Logger::level() const {
-    // 读取 level 也需要加锁，以保证可见性
-    std::lock_guard<std::mutex> lock(mutex_);
-    return level_;
-}
+Level Logger::level() const { return Level(level_.load(std::memory_order_relaxed)); }
 
 const std::string& Logger::name() const { return name_; }
 
@@ -0,0 +1,310 @@
+#include "log/mmap_appender.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#include "log/event.h"
+#include "log/layout.h"
+
+namespace rein {
+namespace log {
+
+namespace {
+
+size_t RoundToPage(size_t size) {
+    const size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    return std::max(page, (size + page - 1) / page * page);
+}
+
+// 在 offset 处写满 size 字节，处理 EINTR 与短写
+bool PwriteAll(int fd, const char* data, size_t size, uint64_t offset) {
+    while (size > 0) {
+        ssize_t n = ::pwrite(fd, data, size, static_cast<off_t>(offset));
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += n;
+        size -= static_cast<size_t>(n);
+        offset += static_cast<uint64_t>(n);
+    }
+    return true;
+}
+
+}  // namespace
+
+MmapFileAppender::MmapFileAppender(const std::string& name, size_t chunk_size)
+    : Appender(AppenderType::MMAP, name),
+      file_name_(name),
+      chunk_size_(RoundToPage(chunk_size)),
+      offset_(0) {
+    SetLayout();
+    Open();
+}
+
+MmapFileAppender::~MmapFileAppender() { Close(); }
+
+void MmapFileAppender::Log(const std::shared_ptr<LogEvent> event, Level level) {
+    if (!level.cmp(event->level())) {
+        return;
+    }
+
+    thread_local fmt::memory_buffer buffer;
+    buffer.clear();
+    layout_->format(buffer, event);
+    Append(buffer.data(), buffer.size());
+}
+
+void MmapFileAppender::Write(const std::shared_ptr<LogEvent>&, fmt::string_view formatted) {
+    Append(formatted.data(), formatted.size());
+}
+
+void MmapFileAppender::Append(const char* data, size_t size) {
+    if (size == 0 || fd_ < 0) {
+        return;
+    }
+
+    // 无锁预留 [pos, pos + size)，记录可能跨越两个（或更多）块
+    const uint64_t pos = offset_.fetch_add(size, std::memory_order_relaxed);
+    const uint64_t first = pos / chunk_size_;
+    const size_t first_offset = static_cast<size_t>(pos % chunk_size_);
+    const size_t first_size = std::min(size, chunk_size_ - first_offset);
+    char* head = Acquire(first);
+
+    // 先写首块之外的部分；映射不到的块（槽位被尚未写完的旧块占着）改用 pwrite
+    size_t done = first_size;
+    uint64_t index = first + 1;
+    while (done < size) {
+        size_t n = std::min(size - done, chunk_size_);
+        char* addr = Acquire(index);
+        if (addr) {
+            std::memcpy(addr, data + done, n);
+        } else {
+            WriteAt(data + done, n, index * chunk_size_);
+        }
+        Commit(index, n, addr != nullptr);
+        done += n;
+        ++index;
+    }
+
+    // 再写首块，首字节最后写入：崩溃时未完成的记录必然以 NUL 开头
+    if (head) {
+        head += first_offset;
+        std::memcpy(head + 1, data + 1, first_size - 1);
+        std::atomic_thread_fence(std::memory_order_release);
+        head[0] = data[0];
+    } else {
+        WriteAt(data + 1, first_size - 1, pos + 1);
+        WriteAt(data, 1, pos);
+    }
+    Commit(first, first_size, head != nullptr);
+}
+
+void MmapFileAppender::WriteAt(const char* data, size_t size, uint64_t offset) {
+    if (!PwriteAll(fd_, data, size, offset)) {
+        fmt::println(stderr, "Write to file '{}' failed, error: {}", file_name_,
+                     std::strerror(errno));
+    }
+}
+
+uint64_t MmapFileAppender::InitialCommitted(uint64_t index) const {
+    // 首块中打开前已有的内容视为已写完
+    const uint64_t begin = index * chunk_size_;
+    return begin < start_ ? std::min<uint64_t>(start_ - begin, chunk_size_) : 0;
+}
+
+char* MmapFileAppender::Acquire(uint64_t index) {
+    Chunk& chunk = slots_[index % kSlots];
+    if (chunk.index.load(std::memory_order_acquire) == index) {
+        char* addr = chunk.addr.load(std::memory_order_acquire);
+        if (addr) {
+            return addr;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(map_mutex_);
+    char* current = chunk.addr.load(std::memory_order_acquire);
+    if (current) {
+        // 槽位是这一块，或者仍被更早的块占用（有写线程还没写完）。
+        // 后一种情况不等待：等待的可能正是被挂起的线程，调用方改用 pwrite
+        return chunk.index.load(std::memory_order_relaxed) == index ? current : nullptr;
+    }
+
+    const off_t begin = static_cast<off_t>(index * chunk_size_);
+    // 用 fallocate 真正分配磁盘空间，避免磁盘满时写映射区触发 SIGBUS
+    int err = ::posix_fallocate(fd_, begin, static_cast<off_t>(chunk_size_));
+    if (err == EINVAL || err == EOPNOTSUPP) {
+        struct stat st;
+        if (::fstat(fd_, &st) == 0 && st.st_size < begin + static_cast<off_t>(chunk_size_)) {
+            err = ::ftruncate(fd_, begin + static_cast<off_t>(chunk_size_)) == 0 ? 0 : errno;
+        } else {
+            err = 0;
+        }
+    }
+    void* addr = err == 0 ? ::mmap(nullptr, chunk_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_,
+                                   begin)
+                          : MAP_FAILED;
+    if (addr == MAP_FAILED) {
+        throw std::runtime_error(fmt::format("Could not map file '{}' at offset {}, error: {}",
+                                             file_name_, begin,
+                                             std::strerror(err ? err : errno)));
+    }
+
+    // 已经用 pwrite 写完的部分也算在内
+    uint64_t committed = InitialCommitted(index);
+    auto early = early_commits_.find(index);
+    if (early != early_commits_.end()) {
+        committed = early->second;
+        early_commits_.erase(early);
+    }
+    chunk.committed.store(committed, std::memory_order_relaxed);
+    chunk.index.store(index, std::memory_order_relaxed);
+    chunk.addr.store(static_cast<char*>(addr), std::memory_order_release);
+    return static_cast<char*>(addr);
+}
+
+void MmapFileAppender::Commit(uint64_t index, size_t bytes, bool mapped) {
+    Chunk& chunk = slots_[index % kSlots];
+    if (mapped) {
+        uint64_t total = chunk.committed.fetch_add(bytes, std::memory_order_acq_rel) + bytes;
+        if (total == chunk_size_) {
+            // 块内所有预留都已完成，不会再有线程访问它
+            std::lock_guard<std::mutex> lock(map_mutex_);
+            Unmap(chunk);
+        }
+        return;
+    }
+
+    // 用 pwrite 写的部分：块此时可能已被别的线程映射，否则先记在 early_commits_ 里
+    std::lock_guard<std::mutex> lock(map_mutex_);
+    if (chunk.index.load(std::memory_order_relaxed) == index &&
+        chunk.addr.load(std::memory_order_relaxed)) {
+        uint64_t total = chunk.committed.fetch_add(bytes, std::memory_order_acq_rel) + bytes;
+        if (total == chunk_size_) {
+            Unmap(chunk);
+        }
+        return;
+    }
+    auto it = early_commits_.find(index);
+    if (it == early_commits_.end()) {
+        it = early_commits_.emplace(index, InitialCommitted(index)).first;
+    }
+    it->second += bytes;
+    if (it->second == chunk_size_) {
+        early_commits_.erase(it);  // 整块都是 pwrite 写的，从未映射
+    }
+}
+
+void MmapFileAppender::Unmap(Chunk& chunk) {
+    char* addr = chunk.addr.exchange(nullptr, std::memory_order_acq_rel);
+    if (addr) {
+        ::munmap(addr, chunk_size_);
+    }
+}
+
+void MmapFileAppender::Open() {
+    fd_ = ::open(file_name_.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd_ < 0) {
+        throw std::runtime_error(fmt::format("Could not open or create file '{}', error: {}",
+                                             file_name_, std::strerror(errno)));
+    }
+
+    struct stat st;
+    if (::fstat(fd_, &st) != 0) {
+        int err = errno;
+        ::close(fd_);
+        fd_ = -1;
+        throw std::runtime_error(
+            fmt::format("Could not stat file '{}', error: {}", file_name_, std::strerror(err)));
+    }
+
+    start_ = static_cast<uint64_t>(st.st_size);
+    Recover(start_);
+    offset_.store(start_, std::memory_order_relaxed);
+}
+
+void MmapFileAppender::Recover(uint64_t size) {
+    // 正常关闭的文件不会以 NUL 结尾；否则是上次崩溃留下的预分配空间
+    char last = 0;
+    if (size == 0 || ::pread(fd_, &last, 1, static_cast<off_t>(size - 1)) != 1 || last != '\0') {
+        return;
+    }
+
+    // 未完成的记录一般只在最后 kSlots 个块中；写线程长时间挂起、其他线程改用 pwrite 写到更后面时，
+    // 更早的空洞不在扫描范围内，保留为 NUL
+    const uint64_t window = std::min<uint64_t>(size, chunk_size_ * kSlots);
+    const uint64_t begin = size - window;
+    std::vector<char> data(window);
+    if (::pread(fd_, data.data(), window, static_cast<off_t>(begin)) !=
+        static_cast<ssize_t>(window)) {
+        return;
+    }
+
+    // 去掉末尾从未被预留的空间
+    size_t end = data.size();
+    while (end > 0 && data[end - 1] == '\0') {
+        --end;
+    }
+
+    // 中间的 NUL 是预留了但没写完的记录：替换为标记，并以换行结束，与下一条记录分开
+    size_t replaced = 0;
+    for (size_t i = 0; i < end; ++i) {
+        if (data[i] != '\0') {
+            continue;
+        }
+        size_t run = i;
+        while (run < end && data[run] == '\0') {
+            data[run++] = kMmapPartialMarker;
+        }
+        if (run - i > 1) {
+            data[run - 1] = '\n';
+        }
+        replaced += run - i;
+        i = run;
+    }
+
+    if (replaced > 0 && !PwriteAll(fd_, data.data(), end, begin)) {
+        // 标记没能写回：保留预分配的尾部，不截断，下次打开时再试
+        fmt::println(stderr, "Recover '{}' failed, error: {}", file_name_, std::strerror(errno));
+        return;
+    }
+    if (::ftruncate(fd_, static_cast<off_t>(begin + end)) == 0) {
+        start_ = begin + end;
+    }
+    if (replaced > 0) {
+        fmt::println(stderr, "Recovered '{}': {} bytes of partially written records marked with '{}'",
+                     file_name_, replaced, kMmapPartialMarker);
+    }
+}
+
+void MmapFileAppender::Close() {
+    if (fd_ < 0) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(map_mutex_);
+    for (auto& chunk : slots_) {
+        Unmap(chunk);
+    }
+
+    // 去掉预分配但没用到的部分
+    if (::ftruncate(fd_, static_cast<off_t>(offset_.load(std::memory_order_acquire))) != 0) {
+        fmt::println(stderr, "Truncate file '{}' failed, error: {}", file_name_,
+                     std::strerror(errno));
+    }
+    ::close(fd_);
+    fd_ = -1;
+}
+
+}  // namespace log
+}  // namespace rein
@@ -0,0 +1,418 @@
+#include "log/net_appender.h"
+
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include "log/event.h"
+#include "log/layout.h"
+
+namespace rein {
+namespace log {
+
+namespace {
+
+// 发送线程等待可写时的轮询间隔，用来及时响应停止
+constexpr int kNetPollIntervalMs = 100;
+constexpr size_t kLengthPrefixSize = 4;
+
+// 等待非阻塞 connect 完成，失败时设置 errno
+bool WaitConnected(int fd) {
+    struct pollfd pfd = {fd, POLLOUT, 0};
+    int rc;
+    do {
+        rc = ::poll(&pfd, 1, static_cast<int>(kNetConnectTimeoutMs));
+    } while (rc < 0 && errno == EINTR);
+    if (rc == 0) {
+        errno = ETIMEDOUT;
+        return false;
+    }
+    if (rc < 0) {
+        return false;
+    }
+    int error = 0;
+    socklen_t length = sizeof(error);
+    if (::getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &length) < 0) {
+        return false;
+    }
+    if (error != 0) {
+        errno = error;
+        return false;
+    }
+    return true;
+}
+
+}  // namespace
+
+NetAppender::NetAppender(const std::string& address, NetFraming framing, size_t buffer_limit)
+    : Appender(AppenderType::NET, address),
+      framing_(framing),
+      buffer_limit_(buffer_limit) {
+    // [tcp://|udp://]host:port，IPv6 地址用方括号括起
+    std::string rest = address;
+    if (rest.compare(0, 6, "tcp://") == 0) {
+        rest = rest.substr(6);
+    } else if (rest.compare(0, 6, "udp://") == 0) {
+        protocol_ = NetProtocol::kUdp;
+        rest = rest.substr(6);
+    }
+    size_t colon;
+    if (!rest.empty() && rest[0] == '[') {
+        size_t bracket = rest.find(']');
+        if (bracket == std::string::npos || bracket + 1 >= rest.size() || rest[bracket + 1] != ':') {
+            throw std::invalid_argument(fmt::format("Invalid network address '{}'", address));
+        }
+        host_ = rest.substr(1, bracket - 1);
+        colon = bracket + 1;
+    } else {
+        colon = rest.rfind(':');
+        if (colon == std::string::npos) {
+            throw std::invalid_argument(fmt::format("Invalid network address '{}'", address));
+        }
+        host_ = rest.substr(0, colon);
+    }
+    port_ = rest.substr(colon + 1);
+    if (host_.empty() || port_.empty() || port_.size() > 5 ||
+        !std::all_of(port_.begin(), port_.end(), [](char c) { return c >= '0' && c <= '9'; }) ||
+        std::stoul(port_) == 0 || std::stoul(port_) > 65535) {
+        throw std::invalid_argument(fmt::format("Invalid network address '{}'", address));
+    }
+
+    SetLayout();
+    sender_ = std::thread(&NetAppender::Run, this);
+}
+
+NetAppender::~NetAppender() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_deadline_ =
+            std::chrono::steady_clock::now() + std::chrono::milliseconds(kNetFlushTimeoutMs);
+        stop_.store(true, std::memory_order_release);
+    }
+    cv_.notify_all();
+    if (sender_.joinable()) {
+        sender_.join();
+    }
+    Disconnect();
+}
+
+void NetAppender::Log(const std::shared_ptr<LogEvent> event, Level level) {
+    if (!level.cmp(event->level())) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    fmt::memory_buffer& data = pending_->data;
+    size_t start = data.size();
+    if (framing_ == NetFraming::kLengthPrefixed) {
+        data.resize(start + kLengthPrefixSize);
+    }
+    layout_->format(data, event);
+    CommitLocked(start);
+}
+
+void NetAppender::Write(const std::shared_ptr<LogEvent>&, fmt::string_view formatted) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    fmt::memory_buffer& data = pending_->data;
+    size_t start = data.size();
+    if (framing_ == NetFraming::kLengthPrefixed) {
+        data.resize(start + kLengthPrefixSize);
+    }
+    data.append(formatted.data(), formatted.data() + formatted.size());
+    CommitLocked(start);
+}
+
+void NetAppender::CommitLocked(size_t start) {
+    fmt::memory_buffer& data = pending_->data;
+    // appended_ - sent_ 同时包含 pending_ 与发送线程换走但尚未发完的一批
+    if (appended_ - sent_ + (data.size() - start) > buffer_limit_) {
+        data.resize(start);
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        if (!overflow_) {
+            overflow_ = true;
+            fmt::println(stderr, "Network appender '{}' buffer is full, dropping records", name_);
+        }
+        return;
+    }
+
+    if (framing_ == NetFraming::kLengthPrefixed) {
+        auto length = static_cast<uint32_t>(data.size() - start - kLengthPrefixSize);
+        for (size_t i = 0; i < kLengthPrefixSize; ++i) {
+            data[start + i] = static_cast<char>(length >> (8 * (kLengthPrefixSize - 1 - i)));
+        }
+    }
+    pending_->ends.push_back(data.size());
+    appended_ += data.size() - start;
+    if (idle_) {
+        idle_ = false;
+        cv_.notify_one();
+    }
+}
+
+void NetAppender::Flush() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    uint64_t target = appended_;
+    if (idle_) {
+        idle_ = false;
+        cv_.notify_one();
+    }
+    sent_cv_.wait_for(lock, std::chrono::milliseconds(kNetFlushTimeoutMs),
+                      [&]() { return sent_ >= target || down_ || stop_.load(); });
+}
+
+void NetAppender::Run() {
+    auto backoff = std::chrono::milliseconds(kNetReconnectMinMs);
+    auto retry_at = std::chrono::steady_clock::now();
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        if (sending_->ends.empty()) {
+            if (pending_->ends.empty()) {
+                if (stop_.load(std::memory_order_acquire)) {
+                    break;
+                }
+                idle_ = true;
+                cv_.wait(lock, [&]() { return stop_.load() || !pending_->ends.empty(); });
+                idle_ = false;
+                continue;
+            }
+            std::swap(pending_, sending_);
+            record_ = 0;
+            offset_ = 0;
+        }
+
+        // 断开期间保留这一批，等重连后从第一条未发完的记录开始
+        if (fd_ < 0) {
+            if (stop_.load(std::memory_order_acquire)) {
+                break;
+            }
+            auto now = std::chrono::steady_clock::now();
+            if (now < retry_at) {
+                cv_.wait_until(lock, retry_at, [&]() { return stop_.load(); });
+                continue;
+            }
+            lock.unlock();
+            std::string error;
+            bool ok = Connect();
+            if (!ok) {
+                error = std::strerror(errno);
+            }
+            lock.lock();
+            if (!ok) {
+                if (!down_) {
+                    fmt::println(stderr, "Could not connect to '{}', error: {}", name_, error);
+                    down_ = true;
+                    sent_cv_.notify_all();
+                }
+                retry_at = std::chrono::steady_clock::now() + backoff;
+                backoff = std::min(backoff * 2, std::chrono::milliseconds(kNetReconnectMaxMs));
+                continue;
+            }
+            down_ = false;
+            backoff = std::chrono::milliseconds(kNetReconnectMinMs);
+        }
+
+        lock.unlock();
+        bool ok = protocol_ == NetProtocol::kTcp ? SendStream() : SendDatagrams();
+        if (!ok) {
+            int error = errno;
+            Disconnect();
+            Rewind();
+            lock.lock();
+            if (!down_) {
+                fmt::println(stderr, "Send to '{}' failed, error: {}", name_, std::strerror(error));
+                down_ = true;
+                sent_cv_.notify_all();
+            }
+            retry_at = std::chrono::steady_clock::now();  // 先立即重连一次，失败后再退避
+            continue;
+        }
+        lock.lock();
+        sent_ += sending_->data.size();
+        sending_->data.clear();
+        sending_->ends.clear();
+        overflow_ = false;
+        sent_cv_.notify_all();
+    }
+
+    // 停止时对端不可用，剩下的记录放弃
+    sent_ += sending_->data.size() + pending_->data.size();
+    sending_->data.clear();
+    sending_->ends.clear();
+    pending_->data.clear();
+    pending_->ends.clear();
+    sent_cv_.notify_all();
+}
+
+bool NetAppender::Connect() {
+    struct addrinfo hints = {};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = protocol_ == NetProtocol::kTcp ? SOCK_STREAM : SOCK_DGRAM;
+    struct addrinfo* result = nullptr;
+    int rc = ::getaddrinfo(host_.c_str(), port_.c_str(), &hints, &result);
+    if (rc != 0) {
+        errno = rc == EAI_SYSTEM ? errno : EHOSTUNREACH;
+        return false;
+    }
+
+    int error = ECONNREFUSED;
+    for (struct addrinfo* ai = result; ai; ai = ai->ai_next) {
+        int fd = ::socket(ai->ai_family, ai->ai_socktype | SOCK_NONBLOCK | SOCK_CLOEXEC,
+                          ai->ai_protocol);
+        if (fd < 0) {
+            error = errno;
+            continue;
+        }
+        if (::connect(fd, ai->ai_addr, ai->ai_addrlen) == 0 ||
+            (errno == EINPROGRESS && WaitConnected(fd))) {
+            fd_ = fd;
+            break;
+        }
+        error = errno;
+        ::close(fd);
+    }
+    ::freeaddrinfo(result);
+    if (fd_ < 0) {
+        errno = error;
+        return false;
+    }
+
+    if (protocol_ == NetProtocol::kTcp) {
+        int on = 1;  // 记录已经成批发送，不需要 Nagle 再攒
+        ::setsockopt(fd_, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+    }
+    connected_.store(true, std::memory_order_relaxed);
+    return true;
+}
+
+void NetAppender::Disconnect() {
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+    connected_.store(false, std::memory_order_relaxed);
+}
+
+bool NetAppender::PeerClosed() const {
+    struct pollfd pfd = {fd_, POLLRDHUP, 0};
+    return ::poll(&pfd, 1, 0) > 0 && (pfd.revents & (POLLRDHUP | POLLHUP | POLLERR));
+}
+
+bool NetAppender::WaitWritable() const {
+    for (;;) {
+        struct pollfd pfd = {fd_, POLLOUT, 0};
+        int rc = ::poll(&pfd, 1, kNetPollIntervalMs);
+        if (rc > 0) {
+            if (pfd.revents & (POLLERR | POLLHUP)) {
+                errno = ECONNRESET;
+                return false;
+            }
+            return true;
+        }
+        if (rc < 0 && errno != EINTR) {
+            return false;
+        }
+        if (stop_.load(std::memory_order_acquire) &&
+            std::chrono::steady_clock::now() >= stop_deadline_) {
+            errno = ETIMEDOUT;
+            return false;
+        }
+    }
+}
+
+bool NetAppender::SendStream() {
+    // 对端已经关闭时先重连，避免这一批写进一个只会被 RST 的连接
+    if (PeerClosed()) {
+        errno = ECONNRESET;
+        return false;
+    }
+
+    fmt::memory_buffer& data = sending_->data;
+    while (offset_ < data.size()) {
+        struct iovec iov = {data.data() + offset_, data.size() - offset_};
+        struct msghdr msg = {};
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        ssize_t n = ::sendmsg(fd_, &msg, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                if (!WaitWritable()) {
+                    return false;
+                }
+                continue;
+            }
+            return false;
+        }
+        offset_ += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+bool NetAppender::SendDatagrams() {
+    struct mmsghdr messages[kNetSendBatch];
+    struct iovec iovs[kNetSendBatch];
+    fmt::memory_buffer& data = sending_->data;
+    const std::vector<size_t>& ends = sending_->ends;
+
+    while (record_ < ends.size()) {
+        size_t count = std::min(kNetSendBatch, ends.size() - record_);
+        size_t start = record_ == 0 ? 0 : ends[record_ - 1];
+        for (size_t i = 0; i < count; ++i) {
+            size_t end = ends[record_ + i];
+            iovs[i].iov_base = data.data() + start;
+            iovs[i].iov_len = end - start;
+            messages[i] = {};
+            messages[i].msg_hdr.msg_iov = &iovs[i];
+            messages[i].msg_hdr.msg_iovlen = 1;
+            start = end;
+        }
+
+        int n = ::sendmmsg(fd_, messages, static_cast<unsigned int>(count), MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR || errno == ECONNREFUSED) {
+                // ECONNREFUSED 是之前的数据报收到的 ICMP 端口不可达，报告一次后即清除
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                if (!WaitWritable()) {
+                    return false;
+                }
+                continue;
+            }
+            if (errno == EMSGSIZE) {
+                // 单条记录超过数据报上限，只能丢弃
+                ++record_;
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+            return false;
+        }
+        record_ += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+void NetAppender::Rewind() {
+    const std::vector<size_t>& ends = sending_->ends;
+    if (protocol_ == NetProtocol::kTcp) {
+        // 已经完整发出的记录不再重发
+        record_ = static_cast<size_t>(std::upper_bound(ends.begin(), ends.end(), offset_) -
+                                      ends.begin());
+    }
+    offset_ = record_ == 0 ? 0 : ends[record_ - 1];
+}
+
+}  // namespace log
+}  // namespace rein
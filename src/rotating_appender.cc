@@ -0,0 +1,482 @@
+#include "log/rotating_appender.h"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#ifdef REIN_LOG_HAS_ZLIB
+    #include <zlib.h>
+#endif
+#ifdef REIN_LOG_HAS_ZSTD
+    #include <zstd.h>
+#endif
+
+#include "log/event.h"
+#include "log/layout.h"
+
+namespace rein {
+namespace log {
+
+namespace {
+
+constexpr size_t kCompressChunk = 64 * 1024;  // 压缩时每次读入的字节数
+
+constexpr size_t kStampSize = 15;             // 归档名中的 YYYYmmdd-HHMMSS
+
+struct ArchiveFile {
+    std::string path;
+    std::string stamp;  // 滚动时间
+    unsigned long seq;  // 同一秒内的序号
+    uint64_t size;
+};
+
+const char* Extension(Compression compression) {
+    switch (compression) {
+        case Compression::kGzip:
+            return ".gz";
+        case Compression::kZstd:
+            return ".zst";
+        default:
+            return "";
+    }
+}
+
+bool EndsWith(const std::string& str, const char* suffix) {
+    size_t n = std::strlen(suffix);
+    return str.size() >= n && str.compare(str.size() - n, n, suffix) == 0;
+}
+
+bool IsTemporary(const std::string& path) { return EndsWith(path, ".tmp"); }
+
+bool IsCompressed(const std::string& path) {
+    return EndsWith(path, Extension(Compression::kGzip)) ||
+           EndsWith(path, Extension(Compression::kZstd));
+}
+
+bool Exists(const std::string& path) { return ::access(path.c_str(), F_OK) == 0; }
+
+void CheckCompression(Compression compression) {
+#ifndef REIN_LOG_HAS_ZLIB
+    if (compression == Compression::kGzip) {
+        throw std::invalid_argument("Gzip compression requires zlib, which was not found at build time");
+    }
+#endif
+#ifndef REIN_LOG_HAS_ZSTD
+    if (compression == Compression::kZstd) {
+        throw std::invalid_argument("Zstd compression requires libzstd, which was not found at build time");
+    }
+#endif
+}
+
+// 本地时间下 from 之后的第一个整点 / 零点
+std::time_t NextBoundary(std::time_t from, RotateInterval interval) {
+    struct tm tm;
+    ::localtime_r(&from, &tm);
+    tm.tm_min = 0;
+    tm.tm_sec = 0;
+    if (interval == RotateInterval::kHourly) {
+        tm.tm_hour += 1;
+    } else {
+        tm.tm_hour = 0;
+        tm.tm_mday += 1;
+    }
+    tm.tm_isdst = -1;  // 由 mktime 判断夏令时
+    return std::mktime(&tm);
+}
+
+// 列出 file 的归档文件："<file>.<数字开头的后缀>"，包括压缩中的临时文件
+std::vector<ArchiveFile> ListArchives(const std::string& file) {
+    std::vector<ArchiveFile> archives;
+    size_t slash = file.rfind('/');
+    std::string dir = slash == std::string::npos ? "." : file.substr(0, slash + 1);
+    std::string prefix = slash == std::string::npos ? "" : dir;
+    std::string base = file.substr(slash == std::string::npos ? 0 : slash + 1) + ".";
+
+    DIR* handle = ::opendir(dir.c_str());
+    if (!handle) {
+        return archives;
+    }
+    while (struct dirent* entry = ::readdir(handle)) {
+        const char* name = entry->d_name;
+        if (std::strncmp(name, base.c_str(), base.size()) != 0 ||
+            !std::isdigit(static_cast<unsigned char>(name[base.size()]))) {
+            continue;
+        }
+        std::string path = prefix + name;
+        struct stat st;
+        if (::stat(path.c_str(), &st) != 0 || !S_ISREG(st.st_mode)) {
+            continue;
+        }
+        const char* stamp = name + base.size();
+        unsigned long seq = 0;
+        if (std::strlen(stamp) > kStampSize && stamp[kStampSize] == '.') {
+            seq = std::strtoul(stamp + kStampSize + 1, nullptr, 10);
+        }
+        archives.push_back({path, std::string(stamp, std::min(std::strlen(stamp), kStampSize)),
+                            seq, static_cast<uint64_t>(st.st_size)});
+    }
+    ::closedir(handle);
+    return archives;
+}
+
+#ifdef REIN_LOG_HAS_ZLIB
+bool GzipFile(const std::string& from, const std::string& to) {
+    std::FILE* in = std::fopen(from.c_str(), "rb");
+    if (!in) {
+        return false;
+    }
+    gzFile out = ::gzopen(to.c_str(), "wb6");
+    if (!out) {
+        std::fclose(in);
+        return false;
+    }
+
+    std::vector<char> chunk(kCompressChunk);
+    bool ok = true;
+    size_t n;
+    while ((n = std::fread(chunk.data(), 1, chunk.size(), in)) > 0) {
+        if (::gzwrite(out, chunk.data(), static_cast<unsigned>(n)) != static_cast<int>(n)) {
+            ok = false;
+            break;
+        }
+    }
+    ok = ok && !std::ferror(in);
+    std::fclose(in);
+    return ::gzclose(out) == Z_OK && ok;
+}
+#endif
+
+#ifdef REIN_LOG_HAS_ZSTD
+bool ZstdFile(const std::string& from, const std::string& to) {
+    std::FILE* in = std::fopen(from.c_str(), "rb");
+    if (!in) {
+        return false;
+    }
+    std::FILE* out = std::fopen(to.c_str(), "wb");
+    ZSTD_CCtx* ctx = out ? ZSTD_createCCtx() : nullptr;
+    if (!ctx) {
+        if (out) {
+            std::fclose(out);
+        }
+        std::fclose(in);
+        return false;
+    }
+    ZSTD_CCtx_setParameter(ctx, ZSTD_c_compressionLevel, 3);
+
+    std::vector<char> input(ZSTD_CStreamInSize());
+    std::vector<char> output(ZSTD_CStreamOutSize());
+    bool ok = true;
+    for (bool last = false; ok && !last;) {
+        size_t n = std::fread(input.data(), 1, input.size(), in);
+        last = n < input.size();
+        ZSTD_inBuffer src = {input.data(), n, 0};
+        for (;;) {
+            ZSTD_outBuffer dst = {output.data(), output.size(), 0};
+            size_t remaining = ZSTD_compressStream2(ctx, &dst, &src,
+                                                    last ? ZSTD_e_end : ZSTD_e_continue);
+            if (ZSTD_isError(remaining) || std::fwrite(output.data(), 1, dst.pos, out) != dst.pos) {
+                ok = false;
+                break;
+            }
+            // 最后一块要把压缩器内部的数据全部刷出，其余块只需读完输入
+            if (last ? remaining == 0 : src.pos == src.size) {
+                break;
+            }
+        }
+    }
+    ok = ok && !std::ferror(in);
+    ZSTD_freeCCtx(ctx);
+    std::fclose(in);
+    return std::fclose(out) == 0 && ok;
+}
+#endif
+
+bool CompressFile(const std::string& from, const std::string& to, Compression compression) {
+    switch (compression) {
+#ifdef REIN_LOG_HAS_ZLIB
+        case Compression::kGzip:
+            return GzipFile(from, to);
+#endif
+#ifdef REIN_LOG_HAS_ZSTD
+        case Compression::kZstd:
+            return ZstdFile(from, to);
+#endif
+        default:
+            return false;
+    }
+}
+
+}  // namespace
+
+RotatingFileAppender::RotatingFileAppender(const std::string& name, const RotationPolicy& policy)
+    : FileAppender(AppenderType::ROTATING, name) {
+    CheckCompression(policy.compression);
+    policy_ = policy;
+
+    // 已有内容的文件按最后修改时间计算时间边界：跨过周期重启时，第一条日志就会滚动
+    std::time_t from = std::time(nullptr);
+    struct stat st;
+    if (fd_ >= 0 && ::fstat(fd_, &st) == 0 && st.st_size > 0) {
+        written_ = static_cast<uint64_t>(st.st_size);
+        from = st.st_mtime;
+    }
+    ScheduleLocked(from);
+
+    busy_ = true;  // 后台线程启动后先做恢复
+    archiver_ = std::thread(&RotatingFileAppender::RunArchiver, this);
+}
+
+RotatingFileAppender::~RotatingFileAppender() {
+    {
+        std::lock_guard<std::mutex> lock(archive_mutex_);
+        stop_ = true;
+    }
+    archive_cv_.notify_all();
+    if (archiver_.joinable()) {
+        archiver_.join();
+    }
+}
+
+void RotatingFileAppender::Log(const std::shared_ptr<LogEvent> event, Level level) {
+    if (!level.cmp(event->level())) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (fd_ < 0) {
+        fmt::println("File is not opened! Please open file...");
+        return;
+    }
+
+    // 先单独渲染，知道长度后才能判断是否需要先滚动
+    record_.clear();
+    layout_->format(record_, event);
+    AppendRecordLocked(event, fmt::string_view(record_.data(), record_.size()));
+}
+
+void RotatingFileAppender::Write(const std::shared_ptr<LogEvent>& event,
+                                 fmt::string_view formatted) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (fd_ < 0) {
+        fmt::println("File is not opened! Please open file...");
+        return;
+    }
+    AppendRecordLocked(event, formatted);
+}
+
+void RotatingFileAppender::SetPolicy(const RotationPolicy& policy) {
+    CheckCompression(policy.compression);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        policy_ = policy;
+        ScheduleLocked(std::time(nullptr));
+    }
+
+    // 保留策略可能变严，交给后台线程按新策略清理一次
+    std::lock_guard<std::mutex> lock(archive_mutex_);
+    tasks_.push_back({std::string(), Compression::kNone});
+    archive_cv_.notify_all();
+}
+
+RotationPolicy RotatingFileAppender::policy() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return policy_;
+}
+
+void RotatingFileAppender::Rotate() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    RollLocked(std::time(nullptr));
+}
+
+void RotatingFileAppender::WaitForArchive() {
+    std::unique_lock<std::mutex> lock(archive_mutex_);
+    archive_cv_.wait(lock, [&]() { return tasks_.empty() && !busy_; });
+}
+
+void RotatingFileAppender::AppendRecordLocked(const std::shared_ptr<LogEvent>& event,
+                                              fmt::string_view formatted) {
+    bool roll = policy_.max_bytes > 0 && written_ > 0 &&
+                written_ + formatted.size() > policy_.max_bytes;
+    std::time_t now = 0;
+    if (next_roll_ != 0) {
+        now = std::chrono::system_clock::to_time_t(event->timestamp());
+        roll = roll || now >= next_roll_;
+    }
+    if (roll) {
+        RollLocked(now != 0 ? now : std::time(nullptr));
+    }
+
+    AppendLocked(event, formatted);
+    written_ += formatted.size();
+}
+
+void RotatingFileAppender::RollLocked(std::time_t now) {
+    FlushLocked();
+    ScheduleLocked(now);
+    if (written_ == 0) {
+        return;  // 空文件不归档
+    }
+    written_ = 0;
+
+    // rename 不影响已打开的 fd：改名后换上新文件即可，旧文件的处理全部交给后台线程
+    std::string archive = ArchiveName(now);
+    if (::rename(file_name_.c_str(), archive.c_str()) != 0) {
+        fmt::println(stderr, "Rename file '{}' to '{}' failed, error: {}", file_name_, archive,
+                     std::strerror(errno));
+        return;
+    }
+    int fd = OpenFile(file_name_);
+    if (fd < 0) {
+        // 继续写已改名的文件，下次滚动时再试
+        fmt::println(stderr, "Could not open or create file '{}', error: {}", file_name_,
+                     std::strerror(errno));
+        return;
+    }
+    ::close(fd_);
+    fd_ = fd;
+
+    std::lock_guard<std::mutex> lock(archive_mutex_);
+    tasks_.push_back({archive, policy_.compression});
+    archive_cv_.notify_all();
+}
+
+void RotatingFileAppender::ScheduleLocked(std::time_t from) {
+    next_roll_ = policy_.interval == RotateInterval::kNone ? 0 : NextBoundary(from, policy_.interval);
+}
+
+std::string RotatingFileAppender::ArchiveName(std::time_t now) {
+    struct tm tm;
+    ::localtime_r(&now, &tm);
+    char stamp[32];
+    std::strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", &tm);
+
+    // 同一秒内多次滚动时追加递增的序号，清理时按它区分新旧
+    seq_ = now == last_roll_ ? seq_ + 1 : 0;
+    last_roll_ = now;
+    std::string base = fmt::format("{}.{}", file_name_, stamp);
+    for (;; ++seq_) {
+        std::string name = seq_ == 0 ? base : fmt::format("{}.{}", base, seq_);
+        if (!Exists(name) && !Exists(name + Extension(Compression::kGzip)) &&
+            !Exists(name + Extension(Compression::kZstd))) {
+            return name;
+        }
+    }
+}
+
+void RotatingFileAppender::RunArchiver() {
+    Recover();
+
+    std::unique_lock<std::mutex> lock(archive_mutex_);
+    busy_ = false;
+    archive_cv_.notify_all();
+    for (;;) {
+        archive_cv_.wait(lock, [&]() { return stop_ || !tasks_.empty(); });
+        if (tasks_.empty()) {
+            break;  // 退出前处理完所有已提交的任务
+        }
+        Task task = std::move(tasks_.front());
+        tasks_.pop_front();
+        busy_ = true;
+        lock.unlock();
+
+        if (!task.path.empty()) {
+            Compress(task.path, task.compression);
+        }
+        Prune();
+
+        lock.lock();
+        busy_ = false;
+        archive_cv_.notify_all();
+    }
+}
+
+void RotatingFileAppender::Recover() {
+    // 上次退出时没压缩完的归档：删掉残留的临时文件，未压缩的重新压缩
+    Compression compression = policy().compression;
+    for (const auto& archive : ListArchives(file_name_)) {
+        if (IsTemporary(archive.path)) {
+            ::unlink(archive.path.c_str());
+        } else if (compression != Compression::kNone && !IsCompressed(archive.path)) {
+            Compress(archive.path, compression);
+        }
+    }
+    Prune();
+}
+
+void RotatingFileAppender::Compress(const std::string& path, Compression compression) {
+    if (compression == Compression::kNone || !Exists(path)) {
+        return;  // 可能已在启动恢复时处理过
+    }
+
+    // 先写临时文件再改名，中途退出不会留下不完整的压缩文件
+    std::string target = path + Extension(compression);
+    std::string temp = target + ".tmp";
+    if (!CompressFile(path, temp, compression)) {
+        fmt::println(stderr, "Compress file '{}' failed, error: {}", path, std::strerror(errno));
+        ::unlink(temp.c_str());
+        return;
+    }
+
+    // 保留原文件的修改时间
+    struct stat st;
+    if (::stat(path.c_str(), &st) == 0) {
+        struct timespec times[2] = {st.st_atim, st.st_mtim};
+        ::utimensat(AT_FDCWD, temp.c_str(), times, 0);
+    }
+    if (::rename(temp.c_str(), target.c_str()) != 0) {
+        fmt::println(stderr, "Rename file '{}' to '{}' failed, error: {}", temp, target,
+                     std::strerror(errno));
+        ::unlink(temp.c_str());
+        return;
+    }
+    ::unlink(path.c_str());
+}
+
+void RotatingFileAppender::Prune() {
+    RotationPolicy policy = this->policy();
+    if (policy.max_files == 0 && policy.max_total_bytes == 0) {
+        return;
+    }
+
+    std::vector<ArchiveFile> archives = ListArchives(file_name_);
+    archives.erase(std::remove_if(archives.begin(), archives.end(),
+                                  [](const ArchiveFile& archive) {
+                                      return IsTemporary(archive.path);
+                                  }),
+                   archives.end());
+    // 按滚动时间与序号从新到旧
+    std::sort(archives.begin(), archives.end(), [](const ArchiveFile& a, const ArchiveFile& b) {
+        if (a.stamp != b.stamp) {
+            return a.stamp > b.stamp;
+        }
+        return a.seq > b.seq;
+    });
+
+    size_t kept = 0;
+    uint64_t total = 0;
+    bool full = false;
+    for (const auto& archive : archives) {
+        full = full || (policy.max_files > 0 && kept >= policy.max_files) ||
+               (policy.max_total_bytes > 0 && total + archive.size > policy.max_total_bytes);
+        if (full) {
+            ::unlink(archive.path.c_str());
+        } else {
+            ++kept;
+            total += archive.size;
+        }
+    }
+}
+
+}  // namespace log
+}  // namespace rein
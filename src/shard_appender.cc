@@ -0,0 +1,358 @@
+#include "log/shard_appender.h"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <queue>
+#include <stdexcept>
+
+#include "log/event.h"
+#include "log/flush_scheduler.h"
+#include "log/layout.h"
+
+namespace rein {
+namespace log {
+
+namespace {
+
+// 每个线程缓存的分片个数（一个线程通常只会用到一两个分片输出地）
+constexpr size_t kShardCacheSlots = 4;
+
+std::atomic<uint64_t> g_sharded_id(0);
+
+// 写满 size 字节，处理 EINTR 与短写
+bool WriteAll(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t n = ::write(fd, data, size);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+// 去掉 .log 后缀后的文件名前缀
+std::string ShardBase(const std::string& name) {
+    const std::string suffix = ".log";
+    if (name.size() > suffix.size() &&
+        name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0) {
+        return name.substr(0, name.size() - suffix.size());
+    }
+    return name;
+}
+
+// 归并的一路输入：当前行与它的排序键
+struct Source {
+    std::FILE* file = nullptr;
+    char* line = nullptr;
+    size_t capacity = 0;
+    size_t size = 0;
+    size_t key = 0;    // 行首时间戳前缀的长度
+    size_t index = 0;  // 在输入中的顺序，键相同时靠前的先输出
+
+    ~Source() { std::free(line); }
+
+    bool Advance() {
+        ssize_t n = ::getline(&line, &capacity, file);
+        if (n < 0) {
+            return false;
+        }
+        size = static_cast<size_t>(n);
+        key = 0;
+        while (key < size && (std::isdigit(static_cast<unsigned char>(line[key])) ||
+                              std::strchr("-:. T", line[key]) != nullptr)) {
+            ++key;
+        }
+        return true;
+    }
+};
+
+struct Later {
+    bool operator()(const Source* lhs, const Source* rhs) const {
+        int cmp = std::memcmp(lhs->line, rhs->line, std::min(lhs->key, rhs->key));
+        if (cmp != 0) {
+            return cmp > 0;
+        }
+        if (lhs->key != rhs->key) {
+            return lhs->key > rhs->key;
+        }
+        return lhs->index > rhs->index;
+    }
+};
+
+// 把 inputs 归并写入 out，不关闭任何文件
+size_t MergeFiles(const std::vector<std::FILE*>& inputs, std::FILE* out) {
+    std::vector<Source> sources(inputs.size());
+    std::priority_queue<Source*, std::vector<Source*>, Later> heap;
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        sources[i].file = inputs[i];
+        sources[i].index = i;
+        if (sources[i].Advance()) {
+            heap.push(&sources[i]);
+        }
+    }
+
+    size_t lines = 0;
+    while (!heap.empty()) {
+        Source* source = heap.top();
+        heap.pop();
+        std::fwrite(source->line, 1, source->size, out);
+        if (source->size == 0 || source->line[source->size - 1] != '\n') {
+            std::fputc('\n', out);  // 分片最后一行可能没有换行（写入方崩溃）
+        }
+        ++lines;
+        if (source->Advance()) {
+            heap.push(source);
+        }
+    }
+    return lines;
+}
+
+// 归并后关闭 files 中的全部文件
+size_t MergeAndClose(std::vector<std::FILE*>& files, std::FILE* out) {
+    size_t lines = MergeFiles(files, out);
+    for (std::FILE* file : files) {
+        std::fclose(file);
+    }
+    files.clear();
+    return lines;
+}
+
+}  // namespace
+
+ShardedFileAppender::ShardedFileAppender(const std::string& name)
+    : Appender(AppenderType::SHARDED, name),
+      file_name_(name),
+      id_(g_sharded_id.fetch_add(1, std::memory_order_relaxed) + 1) {
+    SetLayout();
+}
+
+ShardedFileAppender::~ShardedFileAppender() {
+    FlushScheduler::instance().Unregister(this);
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& entry : shards_) {
+        Shard& shard = *entry.second;
+        std::lock_guard<std::mutex> guard(shard.mutex);
+        FlushShardLocked(shard);
+        if (shard.fd >= 0) {
+            ::close(shard.fd);
+            shard.fd = -1;
+        }
+    }
+}
+
+void ShardedFileAppender::Log(const std::shared_ptr<LogEvent> event, Level level) {
+    if (!level.cmp(event->level())) {
+        return;
+    }
+
+    Shard* shard = ShardFor(event->tid());
+    std::lock_guard<std::mutex> lock(shard->mutex);
+    layout_->format(shard->buffer, event);
+    Append(*shard, *event);
+}
+
+void ShardedFileAppender::Write(const std::shared_ptr<LogEvent>& event,
+                                fmt::string_view formatted) {
+    Shard* shard = ShardFor(event->tid());
+    std::lock_guard<std::mutex> lock(shard->mutex);
+    shard->buffer.append(formatted.data(), formatted.data() + formatted.size());
+    Append(*shard, *event);
+}
+
+void ShardedFileAppender::Append(Shard& shard, const LogEvent& event) {
+    if (shard.buffer.size() >= buffer_size_.load(std::memory_order_relaxed) ||
+        event.level().level() >= flush_level_.load(std::memory_order_relaxed)) {
+        FlushShardLocked(shard);
+    }
+}
+
+ShardedFileAppender::Shard* ShardedFileAppender::ShardFor(pid_t tid) {
+    struct Slot {
+        uint64_t owner = 0;  // 对应 id_
+        pid_t tid = 0;
+        Shard* shard = nullptr;
+    };
+    thread_local Slot slots[kShardCacheSlots];
+    thread_local size_t next_slot = 0;
+
+    for (auto& slot : slots) {
+        if (slot.owner == id_ && slot.tid == tid) {
+            return slot.shard;
+        }
+    }
+
+    // 线程第一次写这个输出地：取得（必要时创建）分片并缓存，之后不再经过 mutex_
+    Shard* shard;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::unique_ptr<Shard>& entry = shards_[tid];
+        if (!entry) {
+            entry.reset(new Shard());
+            entry->file = ShardName(file_name_, tid);
+            entry->fd = ::open(entry->file.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC,
+                               0644);
+            if (entry->fd < 0) {
+                fmt::println(stderr, "Could not open or create file '{}', error: {}",
+                             entry->file, std::strerror(errno));
+            }
+            entry->buffer.reserve(buffer_size_.load(std::memory_order_relaxed));
+        }
+        shard = entry.get();
+    }
+
+    Slot& slot = slots[next_slot++ % kShardCacheSlots];
+    slot.owner = id_;
+    slot.tid = tid;
+    slot.shard = shard;
+    return shard;
+}
+
+void ShardedFileAppender::FlushShardLocked(Shard& shard) {
+    if (shard.fd >= 0 && shard.buffer.size() > 0 &&
+        !WriteAll(shard.fd, shard.buffer.data(), shard.buffer.size())) {
+        fmt::println(stderr, "Write to file '{}' failed, error: {}", shard.file,
+                     std::strerror(errno));
+    }
+    shard.buffer.clear();
+}
+
+void ShardedFileAppender::Flush() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& entry : shards_) {
+        std::lock_guard<std::mutex> guard(entry.second->mutex);
+        FlushShardLocked(*entry.second);
+    }
+}
+
+void ShardedFileAppender::SetBufferSize(size_t bytes) {
+    buffer_size_.store(bytes, std::memory_order_relaxed);
+}
+
+void ShardedFileAppender::SetFlushInterval(std::chrono::milliseconds interval) {
+    if (interval.count() > 0) {
+        FlushScheduler::instance().Register(this, interval);
+    } else {
+        FlushScheduler::instance().Unregister(this);
+    }
+}
+
+void ShardedFileAppender::SetFlushLevel(LevelType level) {
+    flush_level_.store(level, std::memory_order_relaxed);
+}
+
+std::vector<std::string> ShardedFileAppender::shards() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<std::string> files;
+    for (const auto& entry : shards_) {
+        files.push_back(entry.second->file);
+    }
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+std::string ShardedFileAppender::ShardName(const std::string& name, pid_t tid) {
+    return fmt::format("{}.{}.log", ShardBase(name), tid);
+}
+
+std::vector<std::string> FindShards(const std::string& name) {
+    std::string base = ShardBase(name);
+    size_t slash = base.rfind('/');
+    std::string dir = slash == std::string::npos ? "." : base.substr(0, slash + 1);
+    std::string prefix = (slash == std::string::npos ? base : base.substr(slash + 1)) + ".";
+
+    std::vector<std::string> files;
+    DIR* handle = ::opendir(dir.c_str());
+    if (!handle) {
+        return files;
+    }
+    while (struct dirent* entry = ::readdir(handle)) {
+        // <prefix><tid>.log
+        std::string file = entry->d_name;
+        if (file.size() <= prefix.size() + 4 || file.compare(0, prefix.size(), prefix) != 0 ||
+            file.compare(file.size() - 4, 4, ".log") != 0) {
+            continue;
+        }
+        std::string tid = file.substr(prefix.size(), file.size() - prefix.size() - 4);
+        if (std::all_of(tid.begin(), tid.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+            files.push_back(slash == std::string::npos ? file : dir + file);
+        }
+    }
+    ::closedir(handle);
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+size_t MergeShards(const std::vector<std::string>& files, std::FILE* out, size_t fan_in) {
+    fan_in = std::max<size_t>(fan_in, 2);
+
+    // 依次打开一组输入；组满时归并到临时文件，临时文件数再超过上限时继续合并
+    std::vector<std::FILE*> group;
+    std::vector<std::FILE*> runs;
+    auto spill = [&](std::vector<std::FILE*>& inputs) {
+        std::FILE* run = std::tmpfile();
+        if (!run) {
+            throw std::runtime_error(
+                fmt::format("Could not create temporary file, error: {}", std::strerror(errno)));
+        }
+        MergeAndClose(inputs, run);
+        std::rewind(run);
+        runs.push_back(run);
+        if (runs.size() == fan_in) {
+            std::vector<std::FILE*> full;
+            full.swap(runs);
+            std::FILE* merged = std::tmpfile();
+            if (!merged) {
+                throw std::runtime_error(fmt::format("Could not create temporary file, error: {}",
+                                                     std::strerror(errno)));
+            }
+            MergeAndClose(full, merged);
+            std::rewind(merged);
+            runs.push_back(merged);
+        }
+    };
+
+    try {
+        for (const auto& name : files) {
+            std::FILE* file = std::fopen(name.c_str(), "r");
+            if (!file) {
+                throw std::runtime_error(fmt::format("Could not open file '{}', error: {}", name,
+                                                     std::strerror(errno)));
+            }
+            group.push_back(file);
+            if (group.size() == fan_in && files.size() > fan_in) {
+                spill(group);
+            }
+        }
+
+        // 剩下的输入与已经归并好的临时文件一起做最后一轮，总数仍不超过 fan_in
+        if (!group.empty() && runs.size() + group.size() > fan_in) {
+            spill(group);
+        }
+        runs.insert(runs.end(), group.begin(), group.end());
+        group.clear();
+        return MergeAndClose(runs, out);
+    } catch (...) {
+        for (std::FILE* file : group) {
+            std::fclose(file);
+        }
+        for (std::FILE* file : runs) {
+            std::fclose(file);
+        }
+        throw;
+    }
+}
+
+}  // namespace log
+}  // namespace rein
@@ -0,0 +1,194 @@
+#include "log/shm_appender.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+
+#include "log/event.h"
+#include "log/layout.h"
+#include "log/util.hpp"
+
+namespace rein {
+namespace log {
+
+namespace {
+
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2, "shared memory ring needs lock-free 64-bit atomics");
+
+// 另一个进程正在创建同名的环时，等待它初始化完成的上限
+constexpr int kAttachRetries = 1000;
+constexpr auto kAttachInterval = std::chrono::milliseconds(1);
+
+size_t DataOffset() { return (sizeof(ShmRingHeader) + 63) / 64 * 64; }
+
+size_t RoundToPowerOfTwo(size_t size) {
+    size_t capacity = 4096;
+    while (capacity < size) {
+        capacity <<= 1;
+    }
+    return capacity;
+}
+
+}  // namespace
+
+uint64_t ShmRecordChecksum(uint64_t position, const char* data, size_t size) {
+    return util::Hash64(data, size, position);
+}
+
+ShmRingAppender::ShmRingAppender(const std::string& name, size_t capacity)
+    : Appender(AppenderType::SHM, name),
+      shm_name_(ShmName(name)) {
+    SetLayout();
+    Open(RoundToPowerOfTwo(capacity));
+}
+
+ShmRingAppender::~ShmRingAppender() {
+    if (header_) {
+        ::munmap(header_, mapped_size_);
+    }
+}
+
+std::string ShmRingAppender::ShmName(const std::string& name) {
+    return !name.empty() && name[0] == '/' ? name : "/" + name;
+}
+
+bool ShmRingAppender::Remove(const std::string& name) {
+    return ::shm_unlink(ShmName(name).c_str()) == 0;
+}
+
+void ShmRingAppender::Open(size_t capacity) {
+    const size_t offset = DataOffset();
+    int fd = ::shm_open(shm_name_.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+    const bool created = fd >= 0;
+    if (!created && errno == EEXIST) {
+        fd = ::shm_open(shm_name_.c_str(), O_RDWR | O_CLOEXEC, 0);
+    }
+    if (fd < 0) {
+        throw std::runtime_error(fmt::format("Could not open shared memory '{}', error: {}",
+                                             shm_name_, std::strerror(errno)));
+    }
+
+    if (created) {
+        if (::ftruncate(fd, static_cast<off_t>(offset + capacity)) < 0) {
+            int error = errno;
+            ::close(fd);
+            ::shm_unlink(shm_name_.c_str());
+            throw std::runtime_error(fmt::format("Could not resize shared memory '{}', error: {}",
+                                                 shm_name_, std::strerror(error)));
+        }
+    } else {
+        // 沿用已有的环：等创建者设置好大小与文件头，以文件头中的容量为准
+        struct stat st = {};
+        for (int i = 0; i < kAttachRetries; ++i) {
+            if (::fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) >= offset) {
+                break;
+            }
+            std::this_thread::sleep_for(kAttachInterval);
+        }
+        void* addr = static_cast<size_t>(st.st_size) >= offset
+                         ? ::mmap(nullptr, offset, PROT_READ, MAP_SHARED, fd, 0)
+                         : MAP_FAILED;
+        if (addr == MAP_FAILED) {
+            ::close(fd);
+            throw std::runtime_error(
+                fmt::format("Shared memory '{}' is not a log ring", shm_name_));
+        }
+        const auto* header = static_cast<const ShmRingHeader*>(addr);
+        bool valid = false;
+        for (int i = 0; i < kAttachRetries && !valid; ++i) {
+            valid = std::memcmp(header->magic, kShmRingMagic, sizeof(kShmRingMagic)) == 0;
+            if (!valid) {
+                std::this_thread::sleep_for(kAttachInterval);
+            }
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        valid = valid && header->version == kShmRingVersion && header->data_offset == offset &&
+                header->capacity >= 8 && (header->capacity & (header->capacity - 1)) == 0 &&
+                static_cast<size_t>(st.st_size) >= offset + header->capacity;
+        capacity = valid ? static_cast<size_t>(header->capacity) : 0;
+        ::munmap(addr, offset);
+        if (!valid) {
+            ::close(fd);
+            throw std::runtime_error(
+                fmt::format("Shared memory '{}' is not a log ring", shm_name_));
+        }
+    }
+
+    mapped_size_ = offset + capacity;
+    void* addr = ::mmap(nullptr, mapped_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    int error = errno;
+    ::close(fd);
+    if (addr == MAP_FAILED) {
+        if (created) {
+            ::shm_unlink(shm_name_.c_str());
+        }
+        throw std::runtime_error(fmt::format("Could not map shared memory '{}', error: {}",
+                                             shm_name_, std::strerror(error)));
+    }
+    header_ = static_cast<ShmRingHeader*>(addr);
+    data_ = static_cast<char*>(addr) + offset;
+    capacity_ = capacity;
+
+    if (created) {
+        // ftruncate 出来的内存全为 0：head 从 0 开始，提交字都不匹配任何位置
+        header_->version = kShmRingVersion;
+        header_->data_offset = static_cast<uint32_t>(offset);
+        header_->capacity = capacity;
+        std::atomic_thread_fence(std::memory_order_release);
+        std::memcpy(header_->magic, kShmRingMagic, sizeof(kShmRingMagic));
+    }
+}
+
+void ShmRingAppender::Log(const std::shared_ptr<LogEvent> event, Level level) {
+    if (!level.cmp(event->level())) {
+        return;
+    }
+
+    thread_local fmt::memory_buffer buffer;
+    buffer.clear();
+    layout_->format(buffer, event);
+    Publish(buffer.data(), buffer.size(), kShmRecordText);
+}
+
+void ShmRingAppender::Write(const std::shared_ptr<LogEvent>&, fmt::string_view formatted) {
+    Publish(formatted.data(), formatted.size(), kShmRecordText);
+}
+
+bool ShmRingAppender::Publish(const void* data, size_t size, uint16_t type) {
+    const uint64_t total = kShmRecordHeaderSize + ((size + 7) & ~static_cast<uint64_t>(7));
+    if (total > capacity_) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    // 预留 [pos, pos + total)；head 先于数据可见，读者据此发现复制期间被覆盖的记录
+    const uint64_t pos = header_->head.fetch_add(total, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    const uint64_t mask = capacity_ - 1;
+    const uint64_t length = static_cast<uint64_t>(size) | static_cast<uint64_t>(type) << 32;
+    const uint64_t checksum = ShmRecordChecksum(pos, static_cast<const char*>(data), size);
+    std::memcpy(data_ + ((pos + 8) & mask), &length, sizeof(length));
+    std::memcpy(data_ + ((pos + 16) & mask), &checksum, sizeof(checksum));
+
+    // 内容可能跨越数据区末尾
+    const size_t start = static_cast<size_t>((pos + kShmRecordHeaderSize) & mask);
+    const size_t first = std::min(size, capacity_ - start);
+    std::memcpy(data_ + start, data, first);
+    std::memcpy(data_, static_cast<const char*>(data) + first, size - first);
+
+    reinterpret_cast<std::atomic<uint64_t>*>(data_ + (pos & mask))
+        ->store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+}  // namespace log
+}  // namespace rein
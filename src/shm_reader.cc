@@ -0,0 +1,125 @@
+#include "log/shm_reader.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+namespace rein {
+namespace log {
+
+ShmRingReader::ShmRingReader(const std::string& name)
+    : shm_name_(ShmRingAppender::ShmName(name)) {
+    int fd = ::shm_open(shm_name_.c_str(), O_RDONLY | O_CLOEXEC, 0);
+    if (fd < 0) {
+        throw std::runtime_error(fmt::format("Could not open shared memory '{}', error: {}",
+                                             shm_name_, std::strerror(errno)));
+    }
+    struct stat st = {};
+    void* addr = MAP_FAILED;
+    if (::fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) >= sizeof(ShmRingHeader)) {
+        mapped_size_ = static_cast<size_t>(st.st_size);
+        addr = ::mmap(nullptr, mapped_size_, PROT_READ, MAP_SHARED, fd, 0);
+    }
+    ::close(fd);
+    if (addr == MAP_FAILED) {
+        throw std::runtime_error(fmt::format("Shared memory '{}' is not a log ring", shm_name_));
+    }
+
+    header_ = static_cast<const ShmRingHeader*>(addr);
+    bool valid = std::memcmp(header_->magic, kShmRingMagic, sizeof(kShmRingMagic)) == 0;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    valid = valid && header_->version == kShmRingVersion && header_->capacity >= 8 &&
+            (header_->capacity & (header_->capacity - 1)) == 0 &&
+            header_->data_offset + header_->capacity <= mapped_size_;
+    if (!valid) {
+        ::munmap(addr, mapped_size_);
+        throw std::runtime_error(fmt::format("Shared memory '{}' is not a log ring", shm_name_));
+    }
+
+    capacity_ = static_cast<size_t>(header_->capacity);
+    data_ = static_cast<const char*>(addr) + header_->data_offset;
+    buffer_.resize(capacity_);
+
+    // 还没绕回过时所有记录都完整，从头读；否则无从知道最早的记录边界，从写位置开始
+    uint64_t head = header_->head.load(std::memory_order_acquire);
+    position_ = head <= capacity_ ? 0 : head;
+}
+
+ShmRingReader::~ShmRingReader() { ::munmap(const_cast<ShmRingHeader*>(header_), mapped_size_); }
+
+uint64_t ShmRingReader::lag() const {
+    return header_->head.load(std::memory_order_acquire) - position_;
+}
+
+bool ShmRingReader::Next(ShmRecord& record) {
+    const uint64_t mask = capacity_ - 1;
+    for (;;) {
+        uint64_t head = header_->head.load(std::memory_order_acquire);
+        if (head - position_ > capacity_) {
+            Resync(head);
+            continue;
+        }
+        if (head == position_) {
+            return false;
+        }
+
+        const auto* commit =
+            reinterpret_cast<const std::atomic<uint64_t>*>(data_ + (position_ & mask));
+        if (commit->load(std::memory_order_acquire) != position_ + 1) {
+            // 生产者还没写完（或在写完前崩溃，此时等这段空间被覆盖后随 overrun 跳过）
+            return false;
+        }
+
+        uint64_t length;
+        uint64_t checksum;
+        std::memcpy(&length, data_ + ((position_ + 8) & mask), sizeof(length));
+        std::memcpy(&checksum, data_ + ((position_ + 16) & mask), sizeof(checksum));
+        const size_t size = static_cast<uint32_t>(length);
+        const uint64_t total = kShmRecordHeaderSize + ((size + 7) & ~static_cast<uint64_t>(7));
+        if (total <= capacity_) {
+            CopyOut(position_ + kShmRecordHeaderSize, buffer_.data(), size);
+        }
+
+        // 复制完成后 head 仍未越过一圈，说明读到的内容没有被新的写入覆盖
+        std::atomic_thread_fence(std::memory_order_acquire);
+        head = header_->head.load(std::memory_order_relaxed);
+        if (head - position_ > capacity_ || total > capacity_) {
+            Resync(head);
+            continue;
+        }
+        // 被套圈的生产者迟到的写入破坏了这条记录，之后的记录边界也不再可信
+        if (ShmRecordChecksum(position_, buffer_.data(), size) != checksum) {
+            Resync(head);
+            continue;
+        }
+
+        record.type = static_cast<uint16_t>(length >> 32);
+        record.position = position_;
+        record.data = fmt::string_view(buffer_.data(), size);
+        position_ += total;
+        return true;
+    }
+}
+
+void ShmRingReader::CopyOut(uint64_t position, char* out, size_t size) const {
+    const size_t start = static_cast<size_t>(position & (capacity_ - 1));
+    const size_t first = std::min(size, capacity_ - start);
+    std::memcpy(out, data_ + start, first);
+    std::memcpy(out + first, data_, size - first);
+}
+
+void ShmRingReader::Resync(uint64_t head) {
+    ++overruns_;
+    lost_bytes_ += head - position_;
+    position_ = head;
+}
+
+}  // namespace log
+}  // namespace rein
@@ -0,0 +1,56 @@
+#include "log/thread_info.h"
+
+#include <sys/syscall.h>  // for SYS_gettid
+#include <unistd.h>
+
+#include <cstring>
+
+namespace rein {
+namespace log {
+
+namespace {
+
+std::shared_ptr<const ThreadInfo>& Slot() {
+    thread_local std::shared_ptr<const ThreadInfo> info;
+    return info;
+}
+
+}  // namespace
+
+ThreadInfo::ThreadInfo()
+    : tid_(static_cast<pid_t>(::syscall(SYS_gettid))),
+      pthread_id_(pthread_self()) {
+    name_[0] = '\0';
+    pthread_getname_np(pthread_id_, name_, sizeof(name_));
+}
+
+ThreadInfo::ThreadInfo(pid_t tid, pthread_t pthread_id, const char* name)
+    : tid_(tid),
+      pthread_id_(pthread_id) {
+    std::strncpy(name_, name, sizeof(name_) - 1);
+    name_[sizeof(name_) - 1] = '\0';
+}
+
+std::shared_ptr<const ThreadInfo> ThreadInfo::Make(pid_t tid, pthread_t pthread_id,
+                                                   const char* name) {
+    return std::shared_ptr<const ThreadInfo>(new ThreadInfo(tid, pthread_id, name));
+}
+
+const std::shared_ptr<const ThreadInfo>& ThreadInfo::Current() {
+    auto& info = Slot();
+    if (!info) {
+        info.reset(new ThreadInfo());
+    }
+    return info;
+}
+
+void ThreadInfo::Refresh() { Slot().reset(new ThreadInfo()); }
+
+void ThreadInfo::SetName(const std::string& name) {
+    std::string truncated = name.substr(0, sizeof(name_) - 1);
+    pthread_setname_np(pthread_self(), truncated.c_str());
+    Refresh();
+}
+
+}  // namespace log
+}  // namespace rein
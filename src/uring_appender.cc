@@ -0,0 +1,413 @@
+#include "log/uring_appender.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+
+#if defined(__linux__) && defined(__NR_io_uring_setup)
+    #include <linux/io_uring.h>
+    #define REIN_LOG_HAS_IO_URING 1
+#endif
+
+#include "log/event.h"
+#include "log/flush_scheduler.h"
+#include "log/layout.h"
+
+namespace rein {
+namespace log {
+
+#ifdef REIN_LOG_HAS_IO_URING
+
+// 映射到用户态的提交队列与完成队列
+struct UringFileAppender::Ring {
+    int fd = -1;
+    void* sq_ring = MAP_FAILED;
+    size_t sq_ring_size = 0;
+    void* cq_ring = MAP_FAILED;
+    size_t cq_ring_size = 0;
+    struct io_uring_sqe* sqes = static_cast<struct io_uring_sqe*>(MAP_FAILED);
+    size_t sqes_size = 0;
+
+    unsigned* sq_tail = nullptr;
+    unsigned* sq_mask = nullptr;
+    unsigned* sq_array = nullptr;
+    unsigned* cq_head = nullptr;
+    unsigned* cq_tail = nullptr;
+    unsigned* cq_mask = nullptr;
+    struct io_uring_cqe* cqes = nullptr;
+
+    bool fixed_buffers = false;        // 缓冲区已注册，使用 WRITE_FIXED
+    bool fixed_file = false;           // 文件描述符已注册
+    std::vector<struct iovec> iovecs;  // 未注册缓冲区时 WRITEV 使用
+
+    ~Ring() {
+        if (sqes != MAP_FAILED) {
+            ::munmap(sqes, sqes_size);
+        }
+        if (cq_ring != MAP_FAILED && cq_ring != sq_ring) {
+            ::munmap(cq_ring, cq_ring_size);
+        }
+        if (sq_ring != MAP_FAILED) {
+            ::munmap(sq_ring, sq_ring_size);
+        }
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+
+    int Enter(unsigned submit, unsigned min_complete, unsigned flags) {
+        return static_cast<int>(
+            ::syscall(__NR_io_uring_enter, fd, submit, min_complete, flags, nullptr, 0));
+    }
+
+    bool HasCompletion() const {
+        return *cq_head != __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE);
+    }
+};
+
+#else
+
+struct UringFileAppender::Ring {};
+
+#endif
+
+UringFileAppender::UringFileAppender(const std::string& name, size_t buffer_size, size_t buffers)
+    : Appender(AppenderType::URING, name),
+      file_name_(name),
+      buffer_size_(std::max<size_t>(buffer_size, 1)),
+      storage_(new char[buffer_size_ * std::max<size_t>(buffers, 1)]),
+      buffers_(std::max<size_t>(buffers, 1)) {
+    SetLayout();
+    for (size_t i = 0; i < buffers_.size(); ++i) {
+        buffers_[i].data = storage_.get() + i * buffer_size_;
+    }
+    Open();
+    SetupRing();
+}
+
+UringFileAppender::~UringFileAppender() {
+    FlushScheduler::instance().Unregister(this);
+    std::lock_guard<std::mutex> lock(mutex_);
+    SubmitLocked();
+    WaitAllLocked();
+    ring_.reset();
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+void UringFileAppender::Log(const std::shared_ptr<LogEvent> event, Level level) {
+    if (!level.cmp(event->level())) {
+        return;
+    }
+
+    // 在锁外渲染，锁内只做拷贝
+    thread_local fmt::memory_buffer buffer;
+    buffer.clear();
+    layout_->format(buffer, event);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    AppendLocked(buffer.data(), buffer.size(), event->level().level());
+}
+
+void UringFileAppender::Write(const std::shared_ptr<LogEvent>& event, fmt::string_view formatted) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    AppendLocked(formatted.data(), formatted.size(), event->level().level());
+}
+
+void UringFileAppender::Flush() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    SubmitLocked();
+    WaitAllLocked();
+}
+
+void UringFileAppender::SetFlushInterval(std::chrono::milliseconds interval) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        flush_interval_ = interval;
+    }
+    if (interval.count() > 0) {
+        FlushScheduler::instance().Register(this, interval);
+    } else {
+        FlushScheduler::instance().Unregister(this);
+    }
+}
+
+void UringFileAppender::SetFlushLevel(LevelType level) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    flush_level_ = level;
+}
+
+bool UringFileAppender::uring_enabled() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return ring_ != nullptr;
+}
+
+void UringFileAppender::Open() {
+    // 写入位置自己维护（io_uring 的写请求可能乱序完成），因此不用 O_APPEND
+    fd_ = ::open(file_name_.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC, 0644);
+    struct stat st;
+    if (fd_ < 0 || ::fstat(fd_, &st) != 0) {
+        int err = errno;
+        if (fd_ >= 0) {
+            ::close(fd_);
+            fd_ = -1;
+        }
+        throw std::runtime_error(fmt::format("Could not open or create file '{}', error: {}",
+                                             file_name_, std::strerror(err)));
+    }
+    offset_ = static_cast<uint64_t>(st.st_size);
+}
+
+void UringFileAppender::SetupRing() {
+#ifdef REIN_LOG_HAS_IO_URING
+    struct io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+    int fd = static_cast<int>(
+        ::syscall(__NR_io_uring_setup, static_cast<unsigned>(buffers_.size()), &params));
+    if (fd < 0) {
+        return;  // 内核不支持或被禁止：退回同步写
+    }
+
+    std::unique_ptr<Ring> ring(new Ring());
+    ring->fd = fd;
+    ring->sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    ring->cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    const bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single_mmap) {
+        ring->sq_ring_size = ring->cq_ring_size = std::max(ring->sq_ring_size, ring->cq_ring_size);
+    }
+
+    ring->sq_ring = ::mmap(nullptr, ring->sq_ring_size, PROT_READ | PROT_WRITE,
+                           MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    if (ring->sq_ring == MAP_FAILED) {
+        return;
+    }
+    ring->cq_ring = single_mmap ? ring->sq_ring
+                                : ::mmap(nullptr, ring->cq_ring_size, PROT_READ | PROT_WRITE,
+                                         MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+    if (ring->cq_ring == MAP_FAILED) {
+        return;
+    }
+    ring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+    ring->sqes = static_cast<struct io_uring_sqe*>(::mmap(nullptr, ring->sqes_size,
+                                                          PROT_READ | PROT_WRITE,
+                                                          MAP_SHARED | MAP_POPULATE, fd,
+                                                          IORING_OFF_SQES));
+    if (ring->sqes == MAP_FAILED) {
+        return;
+    }
+
+    char* sq = static_cast<char*>(ring->sq_ring);
+    char* cq = static_cast<char*>(ring->cq_ring);
+    ring->sq_tail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+    ring->sq_mask = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+    ring->sq_array = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+    ring->cq_head = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+    ring->cq_tail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+    ring->cq_mask = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+    ring->cqes = reinterpret_cast<struct io_uring_cqe*>(cq + params.cq_off.cqes);
+
+    // 注册缓冲区与文件，省去内核每次请求的页表查找与 fd 引用计数；
+    // 锁定内存超过 RLIMIT_MEMLOCK 等原因注册失败时仍可使用普通请求
+    ring->iovecs.resize(buffers_.size());
+    for (size_t i = 0; i < buffers_.size(); ++i) {
+        ring->iovecs[i].iov_base = buffers_[i].data;
+        ring->iovecs[i].iov_len = buffer_size_;
+    }
+    ring->fixed_buffers = ::syscall(__NR_io_uring_register, fd, IORING_REGISTER_BUFFERS,
+                                    ring->iovecs.data(),
+                                    static_cast<unsigned>(ring->iovecs.size())) == 0;
+    ring->fixed_file = ::syscall(__NR_io_uring_register, fd, IORING_REGISTER_FILES, &fd_, 1) == 0;
+    ring_ = std::move(ring);
+#endif
+}
+
+void UringFileAppender::AppendLocked(const char* data, size_t size, LevelType level) {
+    if (fd_ < 0) {
+        fmt::println("File is not opened! Please open file...");
+        return;
+    }
+
+    // 超过缓冲区剩余空间的日志跨缓冲区拆分，按提交顺序对应连续的文件区间
+    while (size > 0) {
+        Buffer& buffer = buffers_[current_];
+        size_t n = std::min(size, buffer_size_ - buffer.size);
+        std::memcpy(buffer.data + buffer.size, data, n);
+        buffer.size += n;
+        data += n;
+        size -= n;
+        if (buffer.size == buffer_size_) {
+            SubmitLocked();
+        }
+    }
+
+    // 高级别日志需要确保已经写进内核
+    if (level >= flush_level_) {
+        SubmitLocked();
+        WaitAllLocked();
+    }
+}
+
+void UringFileAppender::SubmitLocked() {
+    Buffer& buffer = buffers_[current_];
+    if (buffer.size == 0) {
+        return;
+    }
+
+    buffer.offset = offset_;
+    buffer.done = 0;
+    offset_ += buffer.size;
+    if (ring_) {
+        SubmitWrite(current_);
+    } else {
+        SyncWrite(buffer);
+    }
+
+    // 轮转到下一个缓冲区；它若仍在途，等待其完成
+    current_ = (current_ + 1) % buffers_.size();
+    while (buffers_[current_].in_flight && ring_) {
+        ReapLocked(true);
+    }
+}
+
+void UringFileAppender::SubmitWrite(size_t index) {
+#ifdef REIN_LOG_HAS_IO_URING
+    Ring& ring = *ring_;
+    Buffer& buffer = buffers_[index];
+    const unsigned tail = *ring.sq_tail;
+    const unsigned slot = tail & *ring.sq_mask;
+    struct io_uring_sqe* sqe = &ring.sqes[slot];
+    std::memset(sqe, 0, sizeof(*sqe));
+
+    char* addr = buffer.data + buffer.done;
+    const size_t len = buffer.size - buffer.done;
+    if (ring.fixed_buffers) {
+        sqe->opcode = IORING_OP_WRITE_FIXED;
+        sqe->addr = reinterpret_cast<uint64_t>(addr);
+        sqe->len = static_cast<uint32_t>(len);
+        sqe->buf_index = static_cast<uint16_t>(index);
+    } else {
+        ring.iovecs[index].iov_base = addr;
+        ring.iovecs[index].iov_len = len;
+        sqe->opcode = IORING_OP_WRITEV;
+        sqe->addr = reinterpret_cast<uint64_t>(&ring.iovecs[index]);
+        sqe->len = 1;
+    }
+    if (ring.fixed_file) {
+        sqe->fd = 0;
+        sqe->flags |= IOSQE_FIXED_FILE;
+    } else {
+        sqe->fd = fd_;
+    }
+    sqe->off = buffer.offset + buffer.done;
+    sqe->user_data = index;
+    ring.sq_array[slot] = slot;
+    __atomic_store_n(ring.sq_tail, tail + 1, __ATOMIC_RELEASE);
+
+    int ret;
+    do {
+        ret = ring.Enter(1, 0, 0);
+    } while (ret < 0 && errno == EINTR);
+    if (ret != 1) {
+        // 请求没有被内核取走：撤回后同步写，数据不丢
+        __atomic_store_n(ring.sq_tail, tail, __ATOMIC_RELEASE);
+        SyncWrite(buffer);
+        return;
+    }
+    if (!buffer.in_flight) {
+        buffer.in_flight = true;
+        ++in_flight_;
+    }
+#endif
+}
+
+void UringFileAppender::SyncWrite(Buffer& buffer) {
+    while (buffer.done < buffer.size) {
+        ssize_t n = ::pwrite(fd_, buffer.data + buffer.done, buffer.size - buffer.done,
+                             static_cast<off_t>(buffer.offset + buffer.done));
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            fmt::println(stderr, "Write to file '{}' failed, error: {}", file_name_,
+                         std::strerror(n < 0 ? errno : ENOSPC));
+            break;
+        }
+        buffer.done += static_cast<size_t>(n);
+    }
+    if (buffer.in_flight) {
+        buffer.in_flight = false;
+        --in_flight_;
+    }
+    buffer.size = 0;
+    buffer.done = 0;
+}
+
+void UringFileAppender::ReapLocked(bool wait) {
+#ifdef REIN_LOG_HAS_IO_URING
+    Ring& ring = *ring_;
+    while (wait && !ring.HasCompletion()) {
+        if (ring.Enter(0, 1, IORING_ENTER_GETEVENTS) < 0 && errno != EINTR) {
+            // io_uring 出错：放弃它，在途的缓冲区按原偏移同步重写（重复写同一区间是幂等的）
+            fmt::println(stderr, "io_uring wait failed, falling back to write, error: {}",
+                         std::strerror(errno));
+            ring_.reset();
+            for (auto& buffer : buffers_) {
+                if (buffer.in_flight) {
+                    buffer.done = 0;
+                    SyncWrite(buffer);
+                }
+            }
+            return;
+        }
+    }
+
+    // 完成队列在共享内存中，直接读取
+    unsigned head = *ring.cq_head;
+    const unsigned tail = __atomic_load_n(ring.cq_tail, __ATOMIC_ACQUIRE);
+    for (; head != tail; ++head) {
+        const struct io_uring_cqe& cqe = ring.cqes[head & *ring.cq_mask];
+        Buffer& buffer = buffers_[static_cast<size_t>(cqe.user_data)];
+        const int res = cqe.res;
+        if (res == -EINTR || res == -EAGAIN) {
+            SubmitWrite(static_cast<size_t>(cqe.user_data));
+            continue;
+        }
+        if (res > 0) {
+            buffer.done += static_cast<size_t>(res);
+            if (buffer.done < buffer.size) {
+                SubmitWrite(static_cast<size_t>(cqe.user_data));  // 短写，继续写剩余部分
+                continue;
+            }
+        } else {
+            fmt::println(stderr, "Write to file '{}' failed, error: {}", file_name_,
+                         std::strerror(res < 0 ? -res : ENOSPC));
+        }
+        buffer.in_flight = false;
+        buffer.size = 0;
+        buffer.done = 0;
+        --in_flight_;
+    }
+    __atomic_store_n(ring.cq_head, head, __ATOMIC_RELEASE);
+#endif
+}
+
+void UringFileAppender::WaitAllLocked() {
+    while (in_flight_ > 0 && ring_) {
+        ReapLocked(true);
+    }
+}
+
+}  // namespace log
+}  // namespace rein
@@ -0,0 +1,193 @@
+// 文件: rein_log/tools/rein_log_decode.cc
+
+// 把 BinaryFileAppender 写出的二进制日志还原为文本。
+// 用法: rein_log_decode [选项] 文件...
+//   -p, --pattern <布局>   输出布局，语法与 Layout 相同，默认 kDefaultLayout
+//   -l, --level <级别>     只输出不低于该级别的日志（DEBUG/INFO/WARN/ERROR/FATAL）
+//   -c, --logger <名字>    只输出指定日志器，可重复
+//   -s, --since <时间>     只输出该时间及之后的日志
+//   -u, --until <时间>     只输出该时间之前的日志
+// 时间可以是本地时间 "2024-08-22 19:45:30[.123]"、日期 "2024-08-22" 或 Unix 秒数。
+#include <getopt.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <exception>
+#include <limits>
+#include <memory>
+#include <set>
+#include <string>
+
+#include <fmt/format.h>
+
+#include "log/binary_reader.h"
+#include "log/layout.h"
+#include "log/level.h"
+#include "log/log_constants.h"
+#include "log/logger.h"
+
+namespace {
+
+constexpr size_t kOutputFlushSize = 64 * 1024;
+
+struct Options {
+    std::string pattern = kDefaultLayout;
+    rein::log::Level level = rein::log::Level(rein::log::LevelType::kDebug);
+    std::set<std::string> loggers;
+    uint64_t since = 0;
+    uint64_t until = std::numeric_limits<uint64_t>::max();
+};
+
+void Usage(const char* program) {
+    std::fprintf(stderr,
+                 "Usage: %s [-p pattern] [-l level] [-c logger]... [-s time] [-u time] file...\n"
+                 "  time: \"YYYY-mm-dd HH:MM:SS[.fff]\" (local), \"YYYY-mm-dd\" or Unix seconds\n",
+                 program);
+}
+
+// 解析为 Unix 纳秒，失败返回 false
+bool ParseTime(const char* text, uint64_t& ns) {
+    std::tm tm = {};
+    const char* rest = strptime(text, "%Y-%m-%d %H:%M:%S", &tm);
+    if (!rest) {
+        tm = std::tm();
+        rest = strptime(text, "%Y-%m-%d", &tm);
+    }
+    if (rest) {
+        double fraction = 0;
+        if (*rest == '.') {
+            char* end;
+            fraction = std::strtod(rest, &end);
+            rest = end;
+        }
+        if (*rest != '\0') {
+            return false;
+        }
+        tm.tm_isdst = -1;
+        std::time_t seconds = std::mktime(&tm);
+        if (seconds < 0) {
+            return false;
+        }
+        ns = static_cast<uint64_t>(seconds) * 1000000000ull +
+             static_cast<uint64_t>(fraction * 1e9);
+        return true;
+    }
+
+    char* end;
+    double seconds = std::strtod(text, &end);
+    if (end == text || *end != '\0' || seconds < 0) {
+        return false;
+    }
+    ns = static_cast<uint64_t>(seconds * 1e9);
+    return true;
+}
+
+void WriteOut(fmt::memory_buffer& out) {
+    std::fwrite(out.data(), 1, out.size(), stdout);
+    out.clear();
+}
+
+// 解码一个文件，返回是否成功
+bool Decode(const std::string& file, const Options& options, rein::log::Layout& layout,
+            fmt::memory_buffer& out) {
+    try {
+        rein::log::BinaryLogReader reader(file);
+        while (auto event = reader.Next()) {
+            rein::log::Level level = options.level;
+            if (!level.cmp(event->level())) {
+                continue;
+            }
+            if (!options.loggers.empty() && !options.loggers.count(event->logger()->name())) {
+                continue;
+            }
+            auto wall = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                                  event->timestamp().time_since_epoch())
+                                                  .count());
+            if (wall < options.since || wall >= options.until) {
+                continue;
+            }
+
+            layout.format(out, event);
+            if (out.size() >= kOutputFlushSize) {
+                WriteOut(out);
+            }
+        }
+        WriteOut(out);
+        if (reader.truncated()) {
+            std::fprintf(stderr, "rein_log_decode: '%s' ends with an incomplete record\n",
+                         file.c_str());
+        }
+        return true;
+    } catch (const std::exception& e) {
+        WriteOut(out);
+        std::fprintf(stderr, "rein_log_decode: %s\n", e.what());
+        return false;
+    }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    static const struct option kLongOptions[] = {{"pattern", required_argument, nullptr, 'p'},
+                                                 {"level", required_argument, nullptr, 'l'},
+                                                 {"logger", required_argument, nullptr, 'c'},
+                                                 {"since", required_argument, nullptr, 's'},
+                                                 {"until", required_argument, nullptr, 'u'},
+                                                 {"help", no_argument, nullptr, 'h'},
+                                                 {nullptr, 0, nullptr, 0}};
+
+    Options options;
+    int opt;
+    while ((opt = getopt_long(argc, argv, "p:l:c:s:u:h", kLongOptions, nullptr)) != -1) {
+        switch (opt) {
+            case 'p':
+                options.pattern = optarg;
+                break;
+            case 'l':
+                options.level = rein::log::Level(std::string(optarg));
+                if (options.level.level() == rein::log::LevelType::kUnknown) {
+                    std::fprintf(stderr, "rein_log_decode: unknown level '%s'\n", optarg);
+                    return 2;
+                }
+                break;
+            case 'c':
+                options.loggers.insert(optarg);
+                break;
+            case 's':
+            case 'u':
+                if (!ParseTime(optarg, opt == 's' ? options.since : options.until)) {
+                    std::fprintf(stderr, "rein_log_decode: invalid time '%s'\n", optarg);
+                    return 2;
+                }
+                break;
+            case 'h':
+                Usage(argv[0]);
+                return 0;
+            default:
+                Usage(argv[0]);
+                return 2;
+        }
+    }
+    if (optind >= argc) {
+        Usage(argv[0]);
+        return 2;
+    }
+
+    std::unique_ptr<rein::log::Layout> layout;
+    try {
+        layout.reset(new rein::log::Layout(options.pattern));
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "rein_log_decode: invalid pattern: %s\n", e.what());
+        return 2;
+    }
+
+    fmt::memory_buffer out;
+    bool ok = true;
+    for (int i = optind; i < argc; ++i) {
+        ok = Decode(argv[i], options, *layout, out) && ok;
+    }
+    return ok ? 0 : 1;
+}